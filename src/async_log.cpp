@@ -0,0 +1,196 @@
+#include "async_log.hpp"
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+
+LogRecord* LogQueue::claim()
+{
+    const std::uint64_t t = tail.load(std::memory_order_relaxed);
+    if(t - head.load(std::memory_order_acquire) == CAPACITY) return nullptr;
+    return &records[t & (CAPACITY - 1)];
+}
+
+void LogQueue::publish()
+{
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::uint64_t LogQueue::available() const
+{
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+}
+
+const LogRecord& LogQueue::front() const
+{
+    return records[head.load(std::memory_order_relaxed) & (CAPACITY - 1)];
+}
+
+void LogQueue::pop()
+{
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+AsyncLogWriter* AsyncLogWriter::instance = nullptr;
+
+/// @brief Queue of calling thread and writer it belongs to
+thread_local AsyncLogWriter* queueOwner = nullptr;
+thread_local LogQueue* threadQueue = nullptr;
+
+AsyncLogWriter::AsyncLogWriter(const std::string& path):
+    dropped{0},
+    run{true}
+{
+    const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if(!dir.empty()) std::filesystem::create_directories(dir);
+    file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        std::cerr << "Can not open binary log: " << path << std::endl;
+        exit(1);
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    std::fwrite(log_format::MAGIC, sizeof(log_format::MAGIC), 1, file);
+    instance = this;
+    writer = std::thread(&AsyncLogWriter::job, this);
+    std::cout << "Binary log: " << path << std::endl;
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    run = false;
+    writer.join();
+    instance = nullptr;
+    drain();
+    std::fclose(file);
+    if(dropped.load() > 0) std::cout << "Dropped log records: " << dropped.load() << std::endl;
+}
+
+AsyncLogWriter* AsyncLogWriter::getInstance()
+{
+    return instance;
+}
+
+std::uint16_t AsyncLogWriter::addChannel(const std::string& name, const std::string& fmt)
+{
+    std::scoped_lock lck(mtx);
+    channels.push_back(Channel{name, fmt, false});
+    return static_cast<std::uint16_t>(channels.size() - 1);
+}
+
+void AsyncLogWriter::setFormat(std::uint16_t channel, const std::string& fmt)
+{
+    std::scoped_lock lck(mtx);
+    channels[channel].fmt = fmt;
+    channels[channel].written = false;
+}
+
+void AsyncLogWriter::registerThread()
+{
+    if(instance != nullptr && queueOwner != instance) instance->addQueue();
+}
+
+void AsyncLogWriter::addQueue()
+{
+    // Queue is allocated once and kept until writer exits
+    std::scoped_lock lck(mtx);
+    queues.push_back(std::make_unique<LogQueue>());
+    threadQueue = queues.back().get();
+    queueOwner = this;
+}
+
+LogRecord* AsyncLogWriter::claim()
+{
+    // Fallback for threads not registered at startup
+    if(queueOwner != this) addQueue();
+    LogRecord* record = threadQueue->claim();
+    if(record == nullptr) dropped.fetch_add(1, std::memory_order_relaxed);
+    return record;
+}
+
+void AsyncLogWriter::publish()
+{
+    threadQueue->publish();
+}
+
+void AsyncLogWriter::job()
+{
+    while(run)
+    {
+        if(drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+std::uint64_t AsyncLogWriter::drain()
+{
+    std::vector<LogQueue*> snapshot;
+    std::vector<std::uint64_t> counts;
+    {
+        std::scoped_lock lck(mtx);
+        for(const auto& queue: queues)
+        {
+            snapshot.push_back(queue.get());
+            counts.push_back(queue->available());
+        }
+        // Channel of every counted record was registered before record was pushed
+        writeChannels();
+    }
+    std::uint64_t total = 0;
+    for(std::size_t i = 0; i < snapshot.size(); i++)
+    {
+        for(std::uint64_t n = 0; n < counts[i]; n++)
+        {
+            const LogRecord& record = snapshot[i]->front();
+            const log_format::DataHeader header{log_format::DATA, record.channel, record.count, record.time};
+            std::fwrite(&header, sizeof(header), 1, file);
+            std::fwrite(record.values.data(), sizeof(double), record.count, file);
+            snapshot[i]->pop();
+        }
+        total += counts[i];
+    }
+    return total;
+}
+
+void AsyncLogWriter::writeChannels()
+{
+    for(std::size_t i = 0; i < channels.size(); i++)
+    {
+        Channel& channel = channels[i];
+        if(channel.written) continue;
+        const log_format::ChannelHeader header{log_format::CHANNEL, static_cast<std::uint16_t>(i),
+            static_cast<std::uint16_t>(channel.name.size()), static_cast<std::uint16_t>(channel.fmt.size())};
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(channel.name.data(), 1, channel.name.size(), file);
+        std::fwrite(channel.fmt.data(), 1, channel.fmt.size(), file);
+        channel.written = true;
+    }
+}
+
+LogChannel::LogChannel(const std::string& path):
+    writer{AsyncLogWriter::getInstance()},
+    channel{0}
+{
+    if(writer != nullptr) channel = writer->addChannel(path, "");
+    else text.emplace(path);
+}
+
+LogChannel::LogChannel(const std::string& path, const std::string& fmt):
+    writer{AsyncLogWriter::getInstance()},
+    channel{0}
+{
+    if(writer != nullptr) channel = writer->addChannel(path, fmt);
+    else text.emplace(path, fmt);
+}
+
+LogChannel::LogChannel(const std::string& path, const std::string& fmt, int level):
+    writer{AsyncLogWriter::getInstance()},
+    channel{0}
+{
+    if(writer != nullptr) channel = writer->addChannel(path, fmt);
+    else text.emplace(path, fmt, level);
+}
+
+void LogChannel::setFmt(const std::string& fmt)
+{
+    if(writer != nullptr) writer->setFormat(channel, fmt);
+    else text->setFmt(fmt);
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <Eigen/Dense>
+#include "common.hpp"
+#include "log_format.hpp"
+
+/// @brief Fixed-size log row passed from logging thread to writer thread
+struct LogRecord
+{
+    double time;
+    std::uint16_t channel;
+    std::uint8_t count;
+    std::array<double, log_format::MAX_VALUES> values;
+};
+
+/// @brief Single producer, single consumer queue of log records.
+/// Producer never blocks, record is dropped if queue is full.
+class LogQueue
+{
+public:
+    static constexpr std::uint64_t CAPACITY = 2048;
+
+    /// @brief Returns free slot to fill. Producer side.
+    /// @return pointer to slot, nullptr if queue is full
+    LogRecord* claim();
+
+    /// @brief Makes claimed slot visible to consumer. Producer side.
+    void publish();
+
+    /// @brief Returns number of records ready to read. Consumer side.
+    /// @return records count
+    std::uint64_t available() const;
+
+    /// @brief Returns oldest record. Consumer side.
+    /// @return reference to record
+    const LogRecord& front() const;
+
+    /// @brief Releases oldest record. Consumer side.
+    void pop();
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be power of two");
+
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    alignas(64) std::array<LogRecord, CAPACITY> records;
+};
+
+/// @brief Background writer of binary log. Every logging thread gets own queue, registered when thread starts
+/// or on first record, writer thread drains all queues to one file. Log is converted to CSV files by log_to_csv tool.
+class AsyncLogWriter
+{
+public:
+    /// @brief Constructor. Opens log file and starts writer thread.
+    /// @param path path of binary log file
+    AsyncLogWriter(const std::string& path);
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete; // no copies
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete; // no self-assignments
+
+    /// @brief Deconstructor. Writes remaining records and closes file.
+    ~AsyncLogWriter();
+
+    /// @brief Returns running writer
+    /// @return pointer to writer, nullptr if binary logging is disabled
+    static AsyncLogWriter* getInstance();
+
+    /// @brief Allocates queue of calling thread if binary logging is enabled.
+    /// Called by loop threads at startup, so first record does not allocate or lock.
+    static void registerThread();
+
+    /// @brief Registers channel
+    /// @param name name of CSV file
+    /// @param fmt header of CSV file
+    /// @return channel id
+    std::uint16_t addChannel(const std::string& name, const std::string& fmt);
+
+    /// @brief Changes header of channel
+    /// @param channel channel id
+    /// @param fmt header of CSV file
+    void setFormat(std::uint16_t channel, const std::string& fmt);
+
+    /// @brief Returns free slot in queue of calling thread
+    /// @return pointer to slot, nullptr if queue is full
+    LogRecord* claim();
+
+    /// @brief Publishes slot returned by claim in queue of calling thread
+    void publish();
+
+private:
+    struct Channel
+    {
+        std::string name;
+        std::string fmt;
+        bool written;
+    };
+
+    static AsyncLogWriter* instance;
+
+    void addQueue();
+    void job();
+    std::uint64_t drain();
+    void writeChannels();
+
+    std::FILE* file;
+    std::mutex mtx;
+    std::vector<Channel> channels;
+    std::vector<std::unique_ptr<LogQueue>> queues;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic_bool run;
+    std::thread writer;
+};
+
+/// @brief Log of one CSV file. Writes through Logger, or to binary log if AsyncLogWriter is running.
+/// In binary mode logging is copy of values to queue, formatting is done offline.
+class LogChannel
+{
+public:
+    /// @brief Constructor
+    /// @param path name of log file
+    LogChannel(const std::string& path);
+
+    /// @brief Constructor
+    /// @param path name of log file
+    /// @param fmt header of log file
+    LogChannel(const std::string& path, const std::string& fmt);
+
+    /// @brief Constructor
+    /// @param path name of log file
+    /// @param fmt header of log file
+    /// @param level Logger level
+    LogChannel(const std::string& path, const std::string& fmt, int level);
+
+    /// @brief Changes header of log file
+    /// @param fmt header of log file
+    void setFmt(const std::string& fmt);
+
+    /// @brief Logs one row
+    /// @param time simulation time
+    /// @param values numbers or Eigen vectors, written one after another
+    template <class... Values>
+    void log(double time, const Values&... values)
+    {
+        if(writer == nullptr)
+        {
+            if constexpr ((std::is_arithmetic_v<Values> && ...)) text->log(time, {static_cast<double>(values)...});
+            else text->log(time, {toVector(values)...});
+            return;
+        }
+        LogRecord* record = writer->claim();
+        if(record == nullptr) return;
+        record->time = time;
+        record->channel = channel;
+        std::size_t count = 0;
+        (append(*record, count, values), ...);
+        record->count = static_cast<std::uint8_t>(count);
+        writer->publish();
+    }
+
+private:
+    static void append(LogRecord& record, std::size_t& count, double value)
+    {
+        if(count < log_format::MAX_VALUES) record.values[count++] = value;
+    }
+
+    template <class Derived>
+    static void append(LogRecord& record, std::size_t& count, const Eigen::MatrixBase<Derived>& value)
+    {
+        for(Eigen::Index i = 0; i < value.size() && count < log_format::MAX_VALUES; i++) record.values[count++] = value(i);
+    }
+
+    static Eigen::VectorXd toVector(double value)
+    {
+        return Eigen::VectorXd::Constant(1, value);
+    }
+
+    template <class Derived>
+    static Eigen::VectorXd toVector(const Eigen::MatrixBase<Derived>& value)
+    {
+        return value;
+    }
+
+    AsyncLogWriter* writer;
+    std::uint16_t channel;
+    std::optional<Logger> text;
+};
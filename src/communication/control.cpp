@@ -1,8 +1,16 @@
 #include "control.hpp"
+#include "../controller/controller.hpp"
 #include <iostream>
+#include "../params.hpp"
+#include "../realtime.hpp"
 
-void orderServerJob(zmq::context_t *ctx, std::string uav_address, std::function<std::string(std::string)> handleMsg, bool& run)
+void orderServerJob(zmq::context_t *ctx, std::string uav_address,
+    std::function<std::string(std::string_view)> handleMsg,
+    std::function<std::size_t(std::string_view, order_msg::Reply&)> handleBinaryMsg,
+    std::atomic<std::uint64_t>& orders,
+    bool& run)
 {
+    realtime::configureThread("orders", 0, Params::getSingleton()->IO_CPUS);
     uav_address = uav_address +  "/steer";
     std::cout << "Starting Order server: " + uav_address + "\n";
     zmq::socket_t sock = zmq::socket_t(*ctx, zmq::socket_type::rep);
@@ -18,8 +26,17 @@ void orderServerJob(zmq::context_t *ctx, std::string uav_address, std::function<
             if(zmq_errno() != EAGAIN) std::cerr << "Order server recv error" << std::endl;
             continue;
         } 
-        std::string msg_str =  std::string(static_cast<char*>(msg.data()), msg.size());
-        auto rep = handleMsg(msg_str);
+        const std::string_view content = msg.to_string_view();
+        orders++;
+        if(!content.empty() && static_cast<std::uint8_t>(content[0]) == order_msg::MAGIC)
+        {
+            order_msg::Reply reply;
+            const std::size_t size = handleBinaryMsg(content, reply);
+            zmq::message_t message(&reply, size);
+            sock.send(message,zmq::send_flags::none);
+            continue;
+        }
+        auto rep = handleMsg(content);
         zmq::message_t message(rep.data(), rep.size());
         sock.send(message,zmq::send_flags::none);
     }
@@ -27,18 +44,31 @@ void orderServerJob(zmq::context_t *ctx, std::string uav_address, std::function<
 }
 
 Control::Control(zmq::context_t *ctx, std::string uav_address, ControlSystem* controller):
+inFlight{0},
+frameOpen{false},
+frameDroppable{true},
+frameLen{0},
+commandsSent{0},
+droppedCommands{0},
+commandErrors{0},
+ordersHandled{0},
 _controller{controller}
 {
     std::string address = uav_address + "/control";
     std::cout << "Starting control socket: " << address << std::endl;
-    sock = zmq::socket_t(*ctx, zmq::socket_type::req);
+    // DEALER lets commands be pipelined to REP socket of physic engine
+    sock = zmq::socket_t(*ctx, zmq::socket_type::dealer);
     sock.connect(address);
     run = true;
     orderServer = std::thread(
         orderServerJob, ctx, uav_address,
-        [this](std::string msg) {
+        [this](std::string_view msg) {
              return this->handleMsg(msg); 
         },
+        [this](std::string_view msg, order_msg::Reply& reply) {
+             return this->handleBinaryMsg(msg, reply); 
+        },
+        std::ref(ordersHandled),
         std::ref(run));
 }
 
@@ -47,5 +77,7 @@ Control::~Control()
     run = false;
     orderServer.join();
     std::cout << "Exiting Order Server!" << std::endl;
+    if(droppedCommands > 0 || commandErrors > 0)
+        std::cout << "Commands dropped: " << droppedCommands << ", rejected or not acknowledged: " << commandErrors << std::endl;
     sock.close();
 }
\ No newline at end of file
@@ -5,7 +5,14 @@
 #include <atomic>
 #include <thread>
 #include <functional>
-#include "../controller/controller.hpp"
+#include <string_view>
+#include <array>
+#include <chrono>
+#include "../controller/controller_mode.hpp"
+#include "../defines.hpp"
+#include "shm_ring.hpp"
+#include "order_msg.hpp"
+#include "metrics_msg.hpp"
 
 class ControlSystem;
 
@@ -22,7 +29,7 @@ class Control
         /// @brief Deconstructor
         ~Control();
 
-        /// @brief Sends ping command
+        /// @brief Sends ping command. With shared memory transport waits for command ring instead.
         void prepare();
 
         /// @brief Sends start command
@@ -31,16 +38,16 @@ class Control
         /// @brief Sends stop command
         void stop();
 
-        /// @brief Recivers reply and check if it contains "ok" phrase
+        /// @brief Waits for replies to all commands in flight and checks if they contain "ok" phrase
         void recv();
 
         /// @brief Sends new demanded rotors speed
         /// @param speeds vector of demanded speeds
-        void sendSpeed(Eigen::VectorXd speeds);
+        void sendSpeed(const Eigen::Ref<const Eigen::VectorXd>& speeds);
 
         /// @brief Sends new demanded surface deflactions
         /// @param speeds vector of surface deflactions
-        void sendSurface(Eigen::VectorXd angels);
+        void sendSurface(const Eigen::Ref<const Eigen::VectorXd>& angels);
 
 
         /// @brief Sends command to start jet engine of given index
@@ -55,22 +62,69 @@ class Control
         /// @param value new deflection
         void sendHinge(char type, int index, int hinge_index, double value);
 
+        /// @brief Acknowledges simulator step in lockstep mode, simulator waits for it before next step
+        /// @param step simulator step number
+        void ackStep(std::uint64_t step);
+
+        /// @brief Opens actuator frame. Until commit, rotors, surfaces, hinges and jets commands are collected
+        /// instead of sent. Does nothing if batching is disabled.
+        void beginFrame();
+
+        /// @brief Sends all commands collected since beginFrame as one message
+        void commitFrame();
+
         /// @brief Handle incomming control message - message that instruct controller what to do
-        /// @param msg message content
+        /// @param msg message content, valid only during call
         /// @return reply to message
-        std::string handleMsg(std::string msg);
+        std::string handleMsg(std::string_view msg);
+
+        /// @brief Handle incomming binary control message
+        /// @param msg message content starting with order_msg::Request
+        /// @param reply output reply
+        /// @return number of reply bytes to send
+        std::size_t handleBinaryMsg(std::string_view msg, order_msg::Reply& reply);
 
         void setMode(ControllerMode mode);
 
+        /// @brief Fills command and order counters of metrics message. Safe to call from other thread.
+        /// @param msg metrics message
+        void collectMetrics(metrics_msg::MetricsMsg& msg) const;
+
     private:
-        void sendVectorXd(std::string prefix, Eigen::VectorXd vec);
-        void sendString(std::string msg);
-        std::string handleControl(std::string content);
-        std::string handleMode(std::string content);
-        std::string handleJoystick(std::string content);
+        void sendVectorXd(const char* prefix, const Eigen::Ref<const Eigen::VectorXd>& vec);
+        void commandTooLong();
+        void sendString(std::string_view msg, bool droppable);
+        void sendCommand(std::string_view msg, bool droppable);
+        bool pushRing(std::string_view msg, bool wait);
+        bool sendRaw(std::string_view msg);
+        bool recvReply(zmq::message_t& reply, zmq::recv_flags flags = zmq::recv_flags::none);
+        void drainAcks();
+        std::string handleControl(std::string_view content);
+        std::string handleMode(std::string_view content);
+        std::string handleJoystick(std::string_view content);
+        std::string handleBinaryJoystick(std::string_view content);
+        std::string applyJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes);
+        bool feedJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes);
+        void fillDemands(order_msg::Reply& reply);
 
         bool run;
         std::thread orderServer;
         zmq::socket_t sock;
+        std::unique_ptr<ShmRing> cmd_ring;
+        std::atomic<int> inFlight;
+        /// @brief Time of last acknowledge, or of first send when nothing was in flight
+        std::chrono::steady_clock::time_point lastAck;
+        bool frameOpen;
+        /// @brief Frame contains only commands replaced by next tick (speeds, deflections)
+        bool frameDroppable;
+        /// @brief Serialization buffer of single command, reused every tick
+        std::array<char, def::COMMAND_BUFFER_SIZE> command;
+        /// @brief Batched commands of current tick
+        std::array<char, def::COMMAND_BUFFER_SIZE> frame;
+        std::size_t frameLen;
+        std::atomic<std::uint64_t> commandsSent;
+        std::atomic<std::uint64_t> droppedCommands;
+        std::atomic<std::uint64_t> commandErrors;
+        std::atomic<std::uint64_t> ordersHandled;
         ControlSystem* _controller;
 };
\ No newline at end of file
@@ -1,16 +1,36 @@
 #include "control.hpp"
+#include "../controller/controller.hpp"
 #include <iostream>
+#include <array>
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
 #include "../defines.hpp"
+#include "state_msg.hpp"
 
-std::string Control::handleMsg(std::string msg)
+/// @brief Reads packed little-endian doubles
+/// @param payload packed values
+/// @param count number of values to read, payload must hold them
+/// @param values output values in host order
+void readDoubles(std::string_view payload, int count, std::array<double, def::MAX_JOYSTICK_AXES>& values)
 {
-    std::string content = msg.substr(2); 
+    std::memcpy(values.data(), payload.data(), count*sizeof(double));
+    for(int i = 0; i < count; i++) values[i] = state_msg::fromLittleEndian(values[i]);
+}
+
+std::string Control::handleMsg(std::string_view msg)
+{
+    if(msg.size() < 2) return "unknown";
+    std::string_view content = msg.substr(2); 
     switch(msg.at(0))
     {
         case 'c':
             return handleControl(content);
         case 'j':
             return handleJoystick(content);
+        case 'J':
+            return handleBinaryJoystick(content);
         case 'm':
             return handleMode(content);
     }
@@ -22,21 +42,25 @@ void Control::setMode(ControllerMode mode)
     _controller->setMode(mode);
 }
 
-std::string Control::handleControl(std::string content)
+std::string Control::handleControl(std::string_view content)
 {
     if(content.compare("exit") == 0)
     { 
         _controller->exitController();
         return "ok";
     }
+    if(content.compare("stats") == 0)
+    {
+        return _controller->timingReport();
+    }
     return "unknown";
 }
 
-std::string Control::handleMode(std::string content)
+std::string Control::handleMode(std::string_view content)
 {
     try
     {
-        auto mode = ControllerModeFromString(content.data());
+        auto mode = ControllerModeFromString(content);
         setMode(mode);
         return "ok";
     }
@@ -48,24 +72,118 @@ std::string Control::handleMode(std::string content)
 
 
 
-std::string Control::handleJoystick(std::string content)
+std::string Control::handleJoystick(std::string_view content)
+{
+    std::array<double, def::MAX_JOYSTICK_AXES> values;
+    int count = 0;
+
+    const char* ptr = content.data();
+    const char* const end = ptr + content.size();
+    while(ptr < end && count < def::MAX_JOYSTICK_AXES)
+    {
+        // Like std::stod, any whitespace may precede number, trailing whitespace ends message
+        while(ptr < end && std::isspace(static_cast<unsigned char>(*ptr))) ptr++;
+        if(ptr == end) break;
+        // from_chars does not accept leading plus
+        if(*ptr == '+') ptr++;
+        const auto res = std::from_chars(ptr, end, values[count]);
+        if(res.ec != std::errc()) return "unknown";
+        count++;
+        ptr = std::find(res.ptr, end, ',');
+        if(ptr < end) ptr++;
+    }
+    return applyJoystick(Eigen::Map<const Eigen::VectorXd>(values.data(), count));
+}
+
+std::string Control::handleBinaryJoystick(std::string_view content)
+{
+    // Axes are sent as packed little-endian doubles
+    std::array<double, def::MAX_JOYSTICK_AXES> values;
+    const int count = std::min<std::size_t>(content.size() / sizeof(double), def::MAX_JOYSTICK_AXES);
+    readDoubles(content, count, values);
+    return applyJoystick(Eigen::Map<const Eigen::VectorXd>(values.data(), count));
+}
+
+std::string Control::applyJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes)
+{
+    if(!feedJoystick(axes)) return "ok";
+    return ControllerLoop::demandInfo(_controller->getDemands());
+}
+
+bool Control::feedJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes)
 {
     static int i = 0;
 
-    std::istringstream f(content);
-    std::string value;
-    std::vector<double> values;
+    // Mode is owned by control loop, it takes axes at next tick
+    _controller->queueJoystick(axes);
+    if( i++ < def::INFO_PERIOD ) return false;
+    i = 0;
+    return true;
+}
+
+std::size_t Control::handleBinaryMsg(std::string_view msg, order_msg::Reply& reply)
+{
+    using order_msg::Opcode;
+    using order_msg::Status;
+
+    reply.magic = order_msg::MAGIC;
+    reply.opcode = 0;
+    reply.status = static_cast<std::uint8_t>(Status::OK);
+    reply.hasDemands = 0;
 
-    if(_controller->controller_loop == nullptr)
+    order_msg::Request request;
+    if(msg.size() < sizeof(request))
     {
-        return "ok";
+        reply.status = static_cast<std::uint8_t>(Status::INVALID);
+        return order_msg::REPLY_HEADER_SIZE;
     }
-    while (std::getline(f, value, ',')) {
-        values.push_back(std::stod(value));
+    std::memcpy(&request, msg.data(), sizeof(request));
+    request.arg = state_msg::fromLittleEndian(request.arg);
+    const std::string_view payload = msg.substr(sizeof(request));
+    reply.opcode = request.opcode;
+
+    switch(static_cast<Opcode>(request.opcode))
+    {
+        case Opcode::EXIT:
+            _controller->exitController();
+            break;
+        case Opcode::SET_MODE:
+            if(request.arg >= CONTROLLER_MODE_COUNT)
+            {
+                reply.status = static_cast<std::uint8_t>(Status::INVALID);
+                break;
+            }
+            setMode(static_cast<ControllerMode>(request.arg));
+            break;
+        case Opcode::JOYSTICK:
+        {
+            if(payload.size() < request.arg*sizeof(double))
+            {
+                reply.status = static_cast<std::uint8_t>(Status::INVALID);
+                break;
+            }
+            std::array<double, def::MAX_JOYSTICK_AXES> values;
+            const int count = std::min<int>(request.arg, def::MAX_JOYSTICK_AXES);
+            readDoubles(payload, count, values);
+            if(feedJoystick(Eigen::Map<const Eigen::VectorXd>(values.data(), count))) fillDemands(reply);
+            break;
+        }
+        case Opcode::DEMANDS:
+            fillDemands(reply);
+            break;
+        default:
+            reply.status = static_cast<std::uint8_t>(Status::UNKNOWN);
     }
-    Eigen::Map<Eigen::VectorXd> joystick_values(values.data(), values.size());
-    _controller->controller_loop->handleJoystick(joystick_values);
-    if( i++ < def::INFO_PERIOD ) return "ok";
-    i = 0;
-    return _controller->controller_loop->demandInfo();
-}
\ No newline at end of file
+    return reply.hasDemands ? sizeof(reply) : order_msg::REPLY_HEADER_SIZE;
+}
+
+void Control::fillDemands(order_msg::Reply& reply)
+{
+    const DemandInfo info = _controller->getDemands();
+    // Swapping bytes is symmetric, host to little-endian is the same conversion
+    reply.hasDemands = 1;
+    reply.demands.mode = state_msg::fromLittleEndian<std::int32_t>(info.mode);
+    reply.demands.count = state_msg::fromLittleEndian<std::uint32_t>(info.count);
+    for(std::size_t i = 0; i < info.values.size(); i++)
+        reply.demands.values[i] = state_msg::fromLittleEndian(info.values[i]);
+}
@@ -1,13 +1,25 @@
 #include "control.hpp"
+#include "../controller/controller.hpp"
 #include <iostream>
+#include <charconv>
+#include <algorithm>
+#include <cmath>
+#include "../params.hpp"
+#include "../defines.hpp"
 
 void Control::prepare()
 {
-    zmq::message_t message("c:ping",6);
-    sock.send(message,zmq::send_flags::none);
+    if(Params::getSingleton()->SHM_TRANSPORT)
+    {
+        const std::string ring_name = ShmRing::channelName(UAVparams::getSingleton()->name, "control");
+        std::cout << "Looking for shared memory: " << ring_name << std::endl;
+        while(!(cmd_ring = ShmRing::open(ring_name))) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::cout << "Ready!\n";
+        return;
+    }
+    sendRaw("c:ping");
     zmq::message_t response;
-    auto res = sock.recv(response);
-    if(!res || response.to_string_view().compare("pong") != 0)
+    if(!recvReply(response) || response.to_string_view().compare("pong") != 0)
     {
         std::cerr << "Ping error" << std::endl;
 		exit(1);
@@ -17,85 +29,271 @@ void Control::prepare()
 
 void Control::start()
 {
-    zmq::message_t first_msg("c:start",7);
-    sock.send(first_msg,zmq::send_flags::none);
+    sendString("c:start", false);
     std::cout << "Start!\n";
 }
 
 void Control::stop()
 {
-    //recv();
-
-    zmq::message_t first_msg("c:stop",6);
-    sock.send(first_msg,zmq::send_flags::none);
+    if(cmd_ring)
+    {
+        sendString("c:stop", false);
+        return;
+    }
+    recv();
+    sendRaw("c:stop");
     zmq::message_t response;
-    auto res = sock.recv(response);
-    if(!res && response.str().compare("ok") != 0)
+    if(!recvReply(response) || response.to_string_view().compare("ok") != 0)
     {
         std::cerr << "Stop error" << std::endl;
 		exit(1);
     }
 }
 
-void Control::sendSpeed(Eigen::VectorXd speeds)
+void Control::sendSpeed(const Eigen::Ref<const Eigen::VectorXd>& speeds)
 {
     sendVectorXd("s:",speeds);
 }
 
-void Control::sendSurface(Eigen::VectorXd angels) 
+void Control::sendSurface(const Eigen::Ref<const Eigen::VectorXd>& angels) 
 {
     sendVectorXd("e:",angels);
 }
 
 void Control::startJet(int index) 
 {
-    static const char* prefix = "t:";
-
-    std::stringstream ss;
-    ss << prefix << index;
-    sendString(ss.str());
+    char* ptr = command.data();
+    char* const end = ptr + command.size();
+    *ptr++ = 't';
+    *ptr++ = ':';
+    ptr = std::to_chars(ptr, end, index).ptr;
+    sendCommand(std::string_view(command.data(), ptr - command.data()), false);
 }
 
 void Control::sendHinge(char type, int index, int hinge_index, double value) 
 {
-    static const char* prefix = "h:";
+    char* ptr = command.data();
+    char* const end = ptr + command.size();
+    *ptr++ = 'h';
+    *ptr++ = ':';
+    *ptr++ = type;
+    *ptr++ = ',';
+    ptr = std::to_chars(ptr, end, index).ptr;
+    *ptr++ = ',';
+    ptr = std::to_chars(ptr, end, hinge_index).ptr;
+    *ptr++ = ',';
+    ptr = std::to_chars(ptr, end, value, std::chars_format::general, 6).ptr;
+    sendCommand(std::string_view(command.data(), ptr - command.data()), false);
+}
+
+void Control::sendVectorXd(const char* prefix, const Eigen::Ref<const Eigen::VectorXd>& vec) 
+{
+    // Serialized directly into reused buffer, control loop must not allocate
+    char* ptr = command.data();
+    char* const end = ptr + command.size();
+    while(*prefix) *ptr++ = *prefix++;
+    for(Eigen::Index i = 0; i < vec.size(); i++)
+    {
+        if(i > 0)
+        {
+            if(ptr == end)
+            {
+                commandTooLong();
+                return;
+            }
+            *ptr++ = ',';
+        }
+        const double d = std::abs(vec[i]) < 1e-4 ? 0.0 : vec[i];
+        const auto res = std::to_chars(ptr, end, d, std::chars_format::general, 4);
+        if(res.ec != std::errc())
+        {
+            commandTooLong();
+            return;
+        }
+        ptr = res.ptr;
+    }
+    // Speeds and deflections are sent every tick, lost one is replaced by next
+    sendCommand(std::string_view(command.data(), ptr - command.data()), true);
+}
+
+void Control::commandTooLong()
+{
+    // Truncated command would set wrong number of actuators, it is not sent at all.
+    // Only counted, console output would stall control loop; reported by metrics and exit summary.
+    droppedCommands.fetch_add(1, std::memory_order_relaxed);
+}
 
-    std::stringstream ss;
-    ss << prefix <<type << ',' << index << ',' << hinge_index << ',' << value;
-    sendString(ss.str());
+void Control::ackStep(std::uint64_t step)
+{
+    // Simulator waits for acknowledge before next step, losing it would stop both sides.
+    // It is never dropped by window: sent beyond it, or retried until ring has free slot or physic engine is gone.
+    char* ptr = command.data();
+    *ptr++ = 'k';
+    *ptr++ = ':';
+    ptr = std::to_chars(ptr, command.data() + command.size(), step).ptr;
+    sendString(std::string_view(command.data(), ptr - command.data()), false);
 }
 
-void Control::sendVectorXd(std::string prefix, Eigen::VectorXd vec) 
+void Control::collectMetrics(metrics_msg::MetricsMsg& msg) const
 {
-    static Eigen::IOFormat commaFormat(4, Eigen::DontAlignCols," ",",");
+    msg.commandsSent = commandsSent.load(std::memory_order_relaxed);
+    msg.commandsDropped = droppedCommands.load(std::memory_order_relaxed);
+    msg.commandErrors = commandErrors.load(std::memory_order_relaxed);
+    msg.orders = ordersHandled.load(std::memory_order_relaxed);
+    msg.commandsInFlight = inFlight.load(std::memory_order_relaxed);
+}
 
-    vec = vec.unaryExpr([](auto d) {return std::abs(d) < 1e-4 ? 0.0 : d;});
-    std::stringstream ss;
-    std::string s;
-    ss.precision(5);
-    ss << prefix << vec.format(commaFormat);
-    s = ss.str();
-    sendString(ss.str());
+void Control::beginFrame()
+{
+    if(!Params::getSingleton()->BATCH_COMMANDS) return;
+    frame[0] = 'a';
+    frame[1] = ':';
+    frameLen = 2;
+    frameOpen = true;
+    frameDroppable = true;
+}
+
+void Control::commitFrame()
+{
+    if(!frameOpen) return;
+    frameOpen = false;
+    // Nothing was collected
+    if(frameLen == 2) return;
+    sendString(std::string_view(frame.data(), frameLen), frameDroppable);
 }
 
-void Control::sendString(std::string msg) 
+void Control::sendCommand(std::string_view msg, bool droppable)
+{
+    if(!frameOpen)
+    {
+        sendString(msg, droppable);
+        return;
+    }
+    // Frame is full, send what was collected and continue in next one
+    if(frameLen + 1 + msg.size() > frame.size())
+    {
+        commitFrame();
+        beginFrame();
+    }
+    // Command does not fit even in empty frame, it goes alone
+    if(frameLen + msg.size() > frame.size())
+    {
+        sendString(msg, droppable);
+        return;
+    }
+    if(frameLen > 2) frame[frameLen++] = ';';
+    std::copy(msg.begin(), msg.end(), frame.begin() + frameLen);
+    frameLen += msg.size();
+    frameDroppable = frameDroppable && droppable;
+}
+
+void Control::sendString(std::string_view msg, bool droppable) 
 {
     //std::cout << "[" << msg << "]" << std::endl;
-    recv();
-    zmq::message_t message(msg.data(), msg.size());
-    sock.send(message,zmq::send_flags::none);
+    if(cmd_ring)
+    {
+        if(pushRing(msg, !droppable))
+        {
+            commandsSent.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        cmd_ring->drop();
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    drainAcks();
+    // Never wait for physic engine in control loop. Periodic command is replaced by next one anyway,
+    // one-time commands (start, jets, hinges) are sent beyond window instead.
+    if(droppable && inFlight >= def::COMMAND_WINDOW)
+    {
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if(!sendRaw(msg))
+    {
+        commandErrors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if(inFlight == 0) lastAck = std::chrono::steady_clock::now();
+    inFlight++;
+    commandsSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Control::pushRing(std::string_view msg, bool wait)
+{
+    if(cmd_ring->push(msg.data(), msg.size())) return true;
+    if(!wait || msg.size() > cmd_ring->slotSize()) return false;
+    // One-time command and lockstep acknowledge must arrive, wait until physic engine frees slot.
+    // Wait is bounded, dead physic engine or exit request must not hang control thread.
+    const bool running = _controller != nullptr && _controller->status == Status::running;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(def::ACK_TIMEOUT_MS);
+    while(!cmd_ring->push(msg.data(), msg.size()))
+    {
+        if(std::chrono::steady_clock::now() > deadline) return false;
+        if(running && _controller->status != Status::running) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool Control::sendRaw(std::string_view msg)
+{
+    try
+    {
+        sock.send(zmq::message_t(),zmq::send_flags::sndmore);
+        sock.send(zmq::buffer(msg.data(), msg.size()),zmq::send_flags::none);
+        return true;
+    }
+    catch(const zmq::error_t&)
+    {
+        // Counted by caller, control loop does not write to console
+        return false;
+    }
+}
+
+bool Control::recvReply(zmq::message_t& reply, zmq::recv_flags flags)
+{
+    zmq::message_t delimiter;
+    if(!sock.recv(delimiter, flags)) return false;
+    if(!delimiter.more() || !sock.recv(reply, zmq::recv_flags::none)) return false;
+    return true;
+}
+
+void Control::drainAcks()
+{
+    zmq::message_t reply;
+    while(recvReply(reply, zmq::recv_flags::dontwait))
+    {
+        // Late reply of expired command is consumed without counting
+        if(inFlight > 0) inFlight--;
+        lastAck = std::chrono::steady_clock::now();
+        if(reply.to_string_view().compare("ok") != 0) commandErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Lost reply (e.g. physic engine restart) must not keep window full for rest of run
+    if(inFlight > 0 && std::chrono::steady_clock::now() - lastAck > std::chrono::milliseconds(def::ACK_TIMEOUT_MS))
+    {
+        commandErrors.fetch_add(inFlight, std::memory_order_relaxed);
+        inFlight = 0;
+    }
 }
 
 void Control::recv()
 {
+    // Shared memory commands are not acknowledged
+    if(cmd_ring) return;
     try
     {
-        zmq::message_t response;
-        auto res = sock.recv(response);
-        if(!res && response.str().compare("ok") != 0)
+        drainAcks();
+        while(inFlight > 0)
         {
-            std::cerr << "Recv error" << std::endl;
-		    exit(1);
+            zmq::pollitem_t items[] = {{sock.handle(), 0, ZMQ_POLLIN, 0}};
+            if(zmq::poll(items, 1, std::chrono::milliseconds(1000)) == 0)
+            {
+                std::cerr << "Recv error: " << inFlight << " commands not acknowledged" << std::endl;
+                inFlight = 0;
+                return;
+            }
+            drainAcks();
         }
     }
     catch(const zmq::error_t &ze)
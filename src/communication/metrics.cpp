@@ -0,0 +1,48 @@
+#include "metrics.hpp"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+MetricsPublisher::MetricsPublisher(zmq::context_t *ctx, std::string address, double rate,
+    std::function<void(metrics_msg::MetricsMsg&)> collect):
+    sock(*ctx, zmq::socket_type::pub),
+    period{std::lround(1e6/rate)},
+    collect{collect},
+    run{true}
+{
+    std::cout << "Starting metrics socket: " << address << std::endl;
+    // Slow subscriber must not grow memory, metrics are periodic anyway
+    sock.set(zmq::sockopt::sndhwm, 16);
+    sock.set(zmq::sockopt::linger, 0);
+    sock.bind(address);
+    thread = std::thread(&MetricsPublisher::job, this);
+}
+
+MetricsPublisher::~MetricsPublisher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        run = false;
+    }
+    cv.notify_all();
+    thread.join();
+    sock.close();
+}
+
+void MetricsPublisher::job()
+{
+    char buf[metrics_msg::TOPIC_LEN + sizeof(metrics_msg::MetricsMsg)];
+    std::memcpy(buf, metrics_msg::TOPIC, metrics_msg::TOPIC_LEN);
+    std::unique_lock<std::mutex> lock(mtx);
+    while(!cv.wait_for(lock, period, [this]() { return !run; }))
+    {
+        metrics_msg::MetricsMsg msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.magic = metrics_msg::MAGIC;
+        msg.version = metrics_msg::VERSION;
+        msg.size = sizeof(msg);
+        collect(msg);
+        std::memcpy(buf + metrics_msg::TOPIC_LEN, &msg, sizeof(msg));
+        sock.send(zmq::buffer(static_cast<const void*>(buf), sizeof(buf)), zmq::send_flags::dontwait);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <zmq.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include "metrics_msg.hpp"
+
+/// @brief Publishes controller metrics on PUB socket from own thread, away from control loop
+class MetricsPublisher
+{
+public:
+    /// @brief Constructor
+    /// @param ctx zero mq context
+    /// @param address address of PUB socket
+    /// @param rate publishing rate in Hz
+    /// @param collect function that fills metrics message, called from publisher thread
+    MetricsPublisher(zmq::context_t *ctx, std::string address, double rate,
+        std::function<void(metrics_msg::MetricsMsg&)> collect);
+
+    /// @brief Deconstructor
+    ~MetricsPublisher();
+
+private:
+    void job();
+
+    zmq::socket_t sock;
+    std::chrono::microseconds period;
+    std::function<void(metrics_msg::MetricsMsg&)> collect;
+    bool run;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::thread thread;
+};
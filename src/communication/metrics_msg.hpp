@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// @brief Binary metrics protocol published by controller on metrics socket
+namespace metrics_msg {
+
+/// @brief Topic prefix of metrics message
+constexpr const char TOPIC[] = "m:";
+
+/// @brief Length of topic prefix
+constexpr std::size_t TOPIC_LEN = sizeof(TOPIC) - 1;
+
+/// @brief Magic number opening every metrics message ("UM" in little-endian)
+constexpr std::uint16_t MAGIC = 0x4D55;
+
+/// @brief Version of metrics message layout
+constexpr std::uint16_t VERSION = 1;
+
+/// @brief Maximal length of UAV name, longer names are truncated
+constexpr std::size_t NAME_LEN = 32;
+
+#pragma pack(push, 1)
+/// @brief Timing of one loop since controller start, times in us
+struct LoopMetrics
+{
+    std::uint64_t iterations;
+    std::uint64_t missed;
+    double executionP50;
+    double executionP99;
+    double executionMax;
+    double jitterP99;
+};
+
+/// @brief Packed, little-endian health of controller. Sent after TOPIC prefix.
+struct MetricsMsg
+{
+    std::uint16_t magic;
+    std::uint16_t version;
+    /// @brief size of whole struct in bytes
+    std::uint32_t size;
+    /// @brief null terminated UAV name
+    char name[NAME_LEN];
+    /// @brief simulation time
+    double time;
+
+    LoopMetrics control;
+    LoopMetrics navigation;
+
+    /// @brief state frames published by environment listener
+    std::uint64_t stateFrames;
+    /// @brief state frames rejected as torn, invalid or stale
+    std::uint64_t rejectedFrames;
+    /// @brief state frames dropped by physics engine because shared memory ring was full
+    std::uint64_t droppedFrames;
+    /// @brief commands sent to physics engine
+    std::uint64_t commandsSent;
+    /// @brief commands dropped because of full window or ring
+    std::uint64_t commandsDropped;
+    /// @brief commands rejected by physics engine
+    std::uint64_t commandErrors;
+    /// @brief orders handled by order server
+    std::uint64_t orders;
+    /// @brief commands waiting for acknowledge
+    std::uint32_t commandsInFlight;
+    /// @brief active controller mode
+    std::int32_t mode;
+
+    /// @brief norms of last EKF innovations
+    double innovationBaro;
+    double innovationGPS;
+    double innovationGPSVel;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(double) == 8, "Metrics protocol requires IEEE-754 double");
+}
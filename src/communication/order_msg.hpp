@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "../defines.hpp"
+
+/// @brief Binary order protocol of ground station. Text protocol ("c:", "j:", "m:") is still accepted.
+namespace order_msg {
+
+/// @brief First byte of every binary request and reply, not a printable character so it never starts text order
+constexpr std::uint8_t MAGIC = 0xB5;
+
+/// @brief Operation requested from controller
+enum class Opcode : std::uint8_t
+{
+    /// @brief exit controller, no payload
+    EXIT = 1,
+    /// @brief change mode, arg is mode enum value
+    SET_MODE = 2,
+    /// @brief joystick deflection, arg is number of axes followed by packed doubles
+    JOYSTICK = 3,
+    /// @brief request actual demands, no payload
+    DEMANDS = 4
+};
+
+/// @brief Result of request
+enum class Status : std::uint8_t
+{
+    OK = 0,
+    UNKNOWN = 1,
+    INVALID = 2
+};
+
+#pragma pack(push, 1)
+/// @brief Header of request, little-endian
+struct Request
+{
+    std::uint8_t magic;
+    std::uint8_t opcode;
+    std::uint16_t arg;
+};
+
+/// @brief Demands of controller mode
+struct DemandInfo
+{
+    /// @brief mode enum value
+    std::int32_t mode;
+    /// @brief number of valid values
+    std::uint32_t count;
+    double values[def::MAX_DEMANDS];
+};
+
+/// @brief Reply to request, little-endian. Demands are sent only if hasDemands is set.
+struct Reply
+{
+    std::uint8_t magic;
+    std::uint8_t opcode;
+    std::uint8_t status;
+    std::uint8_t hasDemands;
+    DemandInfo demands;
+};
+#pragma pack(pop)
+
+/// @brief Size of reply without demands
+constexpr std::size_t REPLY_HEADER_SIZE = offsetof(Reply, demands);
+
+static_assert(sizeof(Request) == 4, "Unexpected padding in order request");
+static_assert(sizeof(Reply) == REPLY_HEADER_SIZE + 8 + 8*def::MAX_DEMANDS, "Unexpected padding in order reply");
+}
@@ -0,0 +1,199 @@
+#include "shm_ring.hpp"
+#include <iostream>
+#include <cstring>
+#include <climits>
+#include <new>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/// @brief Layout of ring header placed at beginning of shared memory
+struct ShmRing::Header
+{
+    std::uint32_t magic;
+    std::uint32_t capacity;
+    std::uint32_t slotSize;
+    std::uint32_t slotStride;
+
+    /// @brief number of pushed messages, written only by producer
+    alignas(64) std::atomic<std::uint64_t> head;
+    /// @brief number of popped messages, written only by consumer
+    alignas(64) std::atomic<std::uint64_t> tail;
+    /// @brief futex word, incremented on every push and interrupt
+    alignas(64) std::atomic<std::uint32_t> signal;
+    std::atomic<std::uint32_t> sleeping;
+    std::atomic<std::uint64_t> dropped;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory ring requires lock-free atomics");
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex word must be 32-bit");
+
+namespace {
+constexpr std::uint32_t MAGIC = 0x55524E47; // "URNG"
+
+std::size_t stride(std::uint32_t slotSize)
+{
+    return (sizeof(std::uint32_t) + slotSize + 7) & ~static_cast<std::size_t>(7);
+}
+
+long futex(std::atomic<std::uint32_t>* word, int op, std::uint32_t val, const timespec* timeout)
+{
+    return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), op, val, timeout, nullptr, 0);
+}
+}
+
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name, std::uint32_t capacity, std::uint32_t slotSize)
+{
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0)
+    {
+        std::cerr << "Unable to create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    const std::size_t size = sizeof(Header) + capacity*stride(slotSize);
+    if(ftruncate(fd, size) != 0)
+    {
+        std::cerr << "Unable to resize shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED)
+    {
+        std::cerr << "Unable to map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    Header* header = new (mem) Header;
+    header->capacity = capacity;
+    header->slotSize = slotSize;
+    header->slotStride = stride(slotSize);
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->signal.store(0, std::memory_order_relaxed);
+    header->sleeping.store(0, std::memory_order_relaxed);
+    header->dropped.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+    return std::unique_ptr<ShmRing>(new ShmRing(name, mem, size, true));
+}
+
+std::unique_ptr<ShmRing> ShmRing::open(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if(fd < 0) return nullptr;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header))
+    {
+        close(fd);
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED) return nullptr;
+    Header* header = static_cast<Header*>(mem);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(header->magic != MAGIC
+        || sizeof(Header) + header->capacity*static_cast<std::size_t>(header->slotStride) > static_cast<std::size_t>(st.st_size))
+    {
+        munmap(mem, st.st_size);
+        return nullptr;
+    }
+    return std::unique_ptr<ShmRing>(new ShmRing(name, mem, st.st_size, false));
+}
+
+std::string ShmRing::channelName(const std::string& uav_name, const std::string& channel)
+{
+    return "/uav_" + uav_name + "_" + channel;
+}
+
+ShmRing::ShmRing(std::string name, void* mem, std::size_t size, bool owner):
+    name{name}, mem{mem}, memSize{size}, owner{owner},
+    header{static_cast<Header*>(mem)},
+    slots{static_cast<unsigned char*>(mem) + sizeof(Header)}
+{}
+
+ShmRing::~ShmRing()
+{
+    if(owner)
+    {
+        header->magic = 0;
+        shm_unlink(name.c_str());
+    }
+    munmap(mem, memSize);
+}
+
+bool ShmRing::push(const void* data, std::size_t size)
+{
+    if(size > header->slotSize) return false;
+    const std::uint64_t head = header->head.load(std::memory_order_relaxed);
+    if(head - header->tail.load(std::memory_order_acquire) >= header->capacity) return false;
+    unsigned char* slot = slots + (head % header->capacity)*header->slotStride;
+    const std::uint32_t len = size;
+    std::memcpy(slot, &len, sizeof(len));
+    std::memcpy(slot + sizeof(len), data, size);
+    header->head.store(head + 1, std::memory_order_release);
+    header->signal.fetch_add(1, std::memory_order_seq_cst);
+    if(header->sleeping.load(std::memory_order_seq_cst))
+    {
+        futex(&header->signal, FUTEX_WAKE, 1, nullptr);
+    }
+    return true;
+}
+
+void ShmRing::drop()
+{
+    header->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ShmRing::pop(void* data, std::size_t capacity, std::size_t& size)
+{
+    const std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    if(tail == header->head.load(std::memory_order_acquire)) return false;
+    const unsigned char* slot = slots + (tail % header->capacity)*header->slotStride;
+    std::uint32_t len;
+    std::memcpy(&len, slot, sizeof(len));
+    size = len;
+    std::memcpy(data, slot + sizeof(len), std::min<std::size_t>(len, capacity));
+    header->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool ShmRing::wait(std::chrono::milliseconds timeout)
+{
+    const std::uint32_t signal = header->signal.load(std::memory_order_acquire);
+    if(header->tail.load(std::memory_order_relaxed) != header->head.load(std::memory_order_acquire)) return true;
+    header->sleeping.store(1, std::memory_order_seq_cst);
+    if(header->tail.load(std::memory_order_relaxed) == header->head.load(std::memory_order_seq_cst))
+    {
+        timespec ts;
+        ts.tv_sec = timeout.count() / 1000;
+        ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+        futex(&header->signal, FUTEX_WAIT, signal, &ts);
+    }
+    header->sleeping.store(0, std::memory_order_relaxed);
+    return header->tail.load(std::memory_order_relaxed) != header->head.load(std::memory_order_acquire);
+}
+
+void ShmRing::interrupt()
+{
+    header->signal.fetch_add(1, std::memory_order_seq_cst);
+    futex(&header->signal, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+std::size_t ShmRing::slotSize() const
+{
+    return header->slotSize;
+}
+
+std::uint64_t ShmRing::dropped() const
+{
+    return header->dropped.load(std::memory_order_relaxed);
+}
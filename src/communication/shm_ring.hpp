@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// @brief Single producer, single consumer ring of messages placed in POSIX shared memory.
+/// Producer never blocks (push fails if ring is full), consumer sleeps on futex when ring is empty.
+class ShmRing
+{
+public:
+    /// @brief Creates new ring. Creator owns ring and removes it on destruction.
+    /// @param name shared memory object name
+    /// @param capacity number of slots
+    /// @param slotSize maximal size of single message
+    /// @return pointer to ring, nullptr if creation failed
+    static std::unique_ptr<ShmRing> create(const std::string& name, std::uint32_t capacity, std::uint32_t slotSize);
+
+    /// @brief Opens ring created by other process
+    /// @param name shared memory object name
+    /// @return pointer to ring, nullptr if ring does not exist
+    static std::unique_ptr<ShmRing> open(const std::string& name);
+
+    /// @brief Returns shared memory object name of UAV channel
+    /// @param uav_name name of UAV
+    /// @param channel channel name, "state" or "control"
+    /// @return shared memory object name
+    static std::string channelName(const std::string& uav_name, const std::string& channel);
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /// @brief Deconstructor
+    ~ShmRing();
+
+    /// @brief Copies message to ring and wakes up consumer. Producer side.
+    /// @param data message content
+    /// @param size message size
+    /// @return false if ring is full or message is too long, message is not counted as dropped
+    bool push(const void* data, std::size_t size);
+
+    /// @brief Counts message which producer gave up on. Producer side.
+    void drop();
+
+    /// @brief Copies oldest message from ring. Consumer side.
+    /// @param data output buffer
+    /// @param capacity output buffer size
+    /// @param size size of received message, greater than capacity if message was truncated
+    /// @return false if ring is empty
+    bool pop(void* data, std::size_t capacity, std::size_t& size);
+
+    /// @brief Sleeps until ring is not empty. Consumer side.
+    /// @param timeout maximal sleep time
+    /// @return true if there is message to pop
+    bool wait(std::chrono::milliseconds timeout);
+
+    /// @brief Wakes up consumer sleeping in wait
+    void interrupt();
+
+    /// @brief Returns maximal message size
+    /// @return slot size
+    std::size_t slotSize() const;
+
+    /// @brief Returns number of messages dropped by producer
+    /// @return dropped messages count
+    std::uint64_t dropped() const;
+
+private:
+    struct Header;
+
+    ShmRing(std::string name, void* mem, std::size_t size, bool owner);
+
+    std::string name;
+    void* mem;
+    std::size_t memSize;
+    bool owner;
+    Header* header;
+    unsigned char* slots;
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <bit>
+#include <utility>
+
+/// @brief Binary state protocol published by physics engine
+namespace state_msg {
+
+/// @brief Topic prefix of binary state message
+constexpr const char TOPIC[] = "bs:";
+
+/// @brief Length of topic prefix
+constexpr std::size_t TOPIC_LEN = sizeof(TOPIC) - 1;
+
+/// @brief Magic number opening every state message ("US" in little-endian)
+constexpr std::uint16_t MAGIC = 0x5355;
+
+/// @brief Version of state message layout
+constexpr std::uint16_t VERSION = 2;
+
+#pragma pack(push, 1)
+/// @brief Packed, little-endian state frame of UAV. Sent after TOPIC prefix once per physics step.
+struct StateMsg
+{
+    std::uint16_t magic;
+    std::uint16_t version;
+    /// @brief size of whole struct in bytes
+    std::uint32_t size;
+    /// @brief number of physics step, increases with every frame
+    std::uint64_t seq;
+
+    double time;
+    double position[3];
+    /// @brief quaternion (q0,qx,qy,qz) or RPY in first three fields if quaterions are not used
+    double orientation[4];
+    double linearVelocity[3];
+    double angularVelocity[3];
+    double worldLinearVelocity[3];
+    double worldAngularVelocity[3];
+    double linearAcceleration[3];
+    double angularAcceleration[3];
+
+    /// @brief copy of seq written last, frame is torn if it differs from seq
+    std::uint64_t seqEnd;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(double) == 8, "State protocol requires IEEE-754 double");
+
+/// @brief Converts value stored in little-endian order to host order
+/// @tparam T arithmetic type
+/// @param val value read from message
+/// @return value in host order
+template <typename T>
+inline T fromLittleEndian(T val)
+{
+    if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1)
+    {
+        return val;
+    }
+    else
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &val, sizeof(T));
+        for (std::size_t i = 0; i < sizeof(T)/2; i++)
+        {
+            std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+        }
+        std::memcpy(&val, bytes, sizeof(T));
+        return val;
+    }
+}
+
+/// @brief Decodes state message from raw buffer (without topic prefix). Rejects torn frames.
+/// @param data pointer to message content
+/// @param size size of message content
+/// @param msg output message in host order
+/// @return true if message is valid
+inline bool decode(const void* data, std::size_t size, StateMsg& msg)
+{
+    if(size != sizeof(StateMsg)) return false;
+    std::memcpy(&msg, data, sizeof(StateMsg));
+    msg.magic = fromLittleEndian(msg.magic);
+    msg.version = fromLittleEndian(msg.version);
+    msg.size = fromLittleEndian(msg.size);
+    msg.seq = fromLittleEndian(msg.seq);
+    msg.seqEnd = fromLittleEndian(msg.seqEnd);
+    if(msg.magic != MAGIC || msg.version != VERSION || msg.size != sizeof(StateMsg)) return false;
+    if(msg.seq != msg.seqEnd) return false;
+    if constexpr (std::endian::native != std::endian::little)
+    {
+        unsigned char* fields = reinterpret_cast<unsigned char*>(&msg) + offsetof(StateMsg, time);
+        constexpr std::size_t count = (offsetof(StateMsg, seqEnd) - offsetof(StateMsg, time))/sizeof(double);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            double val;
+            std::memcpy(&val, fields + i*sizeof(double), sizeof(double));
+            val = fromLittleEndian(val);
+            std::memcpy(fields + i*sizeof(double), &val, sizeof(double));
+        }
+    }
+    return true;
+}
+}
@@ -1,16 +1,25 @@
 #include "controller.hpp"
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 #include "../defines.hpp"
+#include "../async_log.hpp"
 #include "../params.hpp"
+#include "../realtime.hpp"
 
 ControlSystem::ControlSystem(
     zmq::context_t *ctx,
     std::string uav_address
     ):
-controller_loop{ControllerLoop::ControllerLoopFactory(ControllerMode::NONE)},
+controller_loop{nullptr},
+pendingMode{NO_MODE},
+appliedJoystick{0},
 control{new Control(ctx, uav_address,this)},
 env(ctx, uav_address),
-navisys(env)
+navisys(env),
+// Lockstep ticks follow simulator, wall clock period and deadline do not apply
+stats("Control loop", Params::getSingleton()->LOCKSTEP ? std::chrono::milliseconds(0)
+    : std::chrono::milliseconds(std::lround(Params::getSingleton()->STEP_TIME*1000.0)))
 {
     const UAVparams* params = UAVparams::getSingleton();
     status = Status::running;
@@ -22,22 +31,41 @@ navisys(env)
     {
         value->set_dt(Params::getSingleton()->STEP_TIME);
     }
+    initMixers();
+    // All modes are constructed once, switching only changes active one
+    for(int i = 0; i < CONTROLLER_MODE_COUNT; i++)
+    {
+        emplaceControllerMode(modes[i], static_cast<ControllerMode>(i));
+        if(!std::visit([this](auto& mode) { return mode.bindControllers(controllers); }, *modes[i])) modes[i].reset();
+    }
+    controller_loop = &*modes[ControllerMode::NONE];
     setMode(ControllerModeFromString(params->initialMode.data()));
     syncWithPhysicEngine(ctx,uav_address);
+    if(Params::getSingleton()->METRICS_RATE > 0.0)
+    {
+        metrics = std::make_unique<MetricsPublisher>(ctx, uav_address + "/metrics", Params::getSingleton()->METRICS_RATE,
+            [this](metrics_msg::MetricsMsg& msg) { collectMetrics(msg); });
+    }
     startLoop();
     std::cout << "Constructing controller done" << std::endl;
 }
 
 ControlSystem::~ControlSystem()
 {
-    delete controller_loop;
+    // Publisher reads other members, stop it first
+    metrics.reset();
     delete control;
+    std::cout << timingReport();
     std::cout << "Exiting controller!" << std::endl;
 }
 
 void ControlSystem::run()
 {
     std::cout << "Initializing controller" << std::endl;
+    const Params* p = Params::getSingleton();
+    realtime::configureThread("control", p->CONTROL_PRIORITY, p->CONTROL_CPUS);
+    AsyncLogWriter::registerThread();
+    if(p->LOCK_MEMORY) realtime::prefaultStack();
     bool run = true;
     
     while(run)
@@ -49,7 +77,6 @@ void ControlSystem::run()
             break;
             case Status::running:
                 control->start();
-                std::cout << "Running in " << ControllerModeToString(controller_loop->getMode()) << " mode" << std::endl;
                 loop->go();
                 control->recv();
             break;
@@ -68,22 +95,55 @@ void ControlSystem::run()
 
 void ControlSystem::startLoop()
 {
-    loop.emplace(std::round(Params::getSingleton()->STEP_TIME*1000.0),[this] () 
+    if(Params::getSingleton()->LOCKSTEP)
     {
-        if(controller_loop == nullptr) return;
-        controller_loop->job(
-            controllers,
-            *control,
-            navisys
+        loop = std::make_unique<SimulationStepClock>(env, [this] (std::uint64_t step)
+        {
+            stats.begin();
+            runStep(true);
+            stats.end();
+            // Simulator proceeds with next step after acknowledge
+            control->ackStep(step);
+        }
+        ,status
         );
+        return;
+    }
+    const bool fused = Params::getSingleton()->FUSED_PIPELINE;
+    loop = std::make_unique<WallClock>(std::round(Params::getSingleton()->STEP_TIME*1000.0),
+        [this, fused] (std::chrono::steady_clock::time_point scheduled)
+    {
+        stats.begin(scheduled);
+        runStep(fused);
+        stats.end();
     }
     ,status
     );
 }
 
+void ControlSystem::runStep(bool fused)
+{
+    if(fused) navisys.fusedStep();
+    applyPendingMode();
+    ControllerModes* active = controller_loop.load(std::memory_order_relaxed);
+    if(active == nullptr) return;
+    applyJoystick(*active);
+    control->beginFrame();
+    std::visit([this](auto& mode) { mode.job(*control, navisys); }, *active);
+    control->commitFrame();
+    demands.store(std::visit([](auto& mode) { return mode.demands(); }, *active));
+}
+
 void ControlSystem::syncWithPhysicEngine(zmq::context_t *ctx, std::string uav_address)
 {
     std::cout << "Attempting to sync..." << std::endl;
+    if(Params::getSingleton()->SHM_TRANSPORT)
+    {
+        // Physics engine is ready once it created shared memory rings
+        control->prepare();
+        std::cout << "Synchronized!" << std::endl;
+        return;
+    }
 	zmq::socket_t sock = zmq::socket_t(*ctx, zmq::socket_type::sub);
 	sock.set(zmq::sockopt::subscribe, "idle");
 	sock.connect(uav_address + "/state");
@@ -105,21 +165,88 @@ void ControlSystem::syncWithPhysicEngine(zmq::context_t *ctx, std::string uav_ad
 
 void ControlSystem::setMode(ControllerMode new_mode)
 {
-    auto new_loop = ControllerLoop::ControllerLoopFactory(new_mode);
-    for (auto& Controller_name: new_loop->requiredcontrollers())
+    if(new_mode < 0 || new_mode >= CONTROLLER_MODE_COUNT || !modes[new_mode].has_value())
     {
-        if(!controllers.contains(Controller_name))
-        {
-            std::cerr << "Missing Controller " << Controller_name << " to run "
-                << ControllerModeToString(new_mode) << " mode" << std::endl;
-            return;
-        }
+        std::cerr << "Mode " << ControllerModeToString(new_mode) << " is not available" << std::endl;
+        return;
     }
-    new_loop->overridePositionAndSpeed(navisys.getPosition(),navisys.getOrientation(),
-        navisys.getRotationMatrixBodyToWorld().colPivHouseholderQr().solve(navisys.getLinearVelocity()));
-    std::swap(new_loop,controller_loop);
-    if(new_loop != nullptr) delete new_loop;
-    status = Status::reload;
+    // Applied by control loop at beginning of next tick, reported here to keep console out of the loop
+    pendingMode.store(new_mode, std::memory_order_release);
+    std::cout << "Switching to " << ControllerModeToString(new_mode) << " mode" << std::endl;
+}
+
+void ControlSystem::applyPendingMode()
+{
+    const int new_mode = pendingMode.exchange(NO_MODE, std::memory_order_acquire);
+    if(new_mode == NO_MODE) return;
+    ControllerModes* new_loop = &*modes[new_mode];
+    const NavigationSolution nav = navisys.getSolution();
+    const Eigen::Vector3d velocity = nav.R_bw.colPivHouseholderQr().solve(nav.linearVelocity);
+    std::visit([&](auto& mode)
+    {
+        mode.reset();
+        mode.overridePositionAndSpeed(nav.position, nav.orientation, velocity);
+    }, *new_loop);
+    controller_loop.store(new_loop, std::memory_order_release);
+}
+
+void ControlSystem::applyJoystick(ControllerModes& active)
+{
+    if(joystick.version() == appliedJoystick) return;
+    const JoystickInput input = joystick.load(appliedJoystick);
+    const Eigen::Map<const Eigen::VectorXd> axes(input.axes.data(), input.count);
+    std::visit([&axes](auto& mode) { mode.handleJoystick(axes); }, active);
+}
+
+void ControlSystem::queueJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes)
+{
+    JoystickInput input;
+    input.count = std::min<int>(axes.size(), def::MAX_JOYSTICK_AXES);
+    std::copy(axes.data(), axes.data() + input.count, input.axes.begin());
+    joystick.store(input);
+}
+
+DemandInfo ControlSystem::getDemands() const
+{
+    return demands.load();
+}
+
+/// @brief Converts loop statistics to metrics message format
+/// @param stats loop statistics
+/// @param out loop metrics
+void fillLoopMetrics(const LoopStats& stats, metrics_msg::LoopMetrics& out)
+{
+    constexpr double NS_TO_US = 1e-3;
+    out.iterations = stats.count();
+    out.missed = stats.missedDeadlines();
+    out.executionP50 = stats.executionTime().percentile(0.5)*NS_TO_US;
+    out.executionP99 = stats.executionTime().percentile(0.99)*NS_TO_US;
+    out.executionMax = stats.executionTime().max()*NS_TO_US;
+    out.jitterP99 = stats.periodJitter().percentile(0.99)*NS_TO_US;
+}
+
+void ControlSystem::collectMetrics(metrics_msg::MetricsMsg& msg)
+{
+    const std::string name(UAVparams::getSingleton()->name);
+    std::strncpy(msg.name, name.c_str(), metrics_msg::NAME_LEN - 1);
+    msg.time = env.getTime();
+    fillLoopMetrics(stats, msg.control);
+    fillLoopMetrics(navisys.loopStats(), msg.navigation);
+    msg.stateFrames = env.getStateFrames();
+    msg.rejectedFrames = env.getRejectedFrames();
+    msg.droppedFrames = env.getDroppedFrames();
+    control->collectMetrics(msg);
+    ControllerModes* active = controller_loop.load(std::memory_order_acquire);
+    msg.mode = active == nullptr ? ControllerMode::NONE : std::visit([](auto& mode) { return mode.getMode(); }, *active);
+    const EKFInnovations innovations = navisys.getInnovations();
+    msg.innovationBaro = innovations.baro;
+    msg.innovationGPS = innovations.gps;
+    msg.innovationGPSVel = innovations.gpsVel;
+}
+
+std::string ControlSystem::timingReport() const
+{
+    return stats.report() + navisys.timingReport();
 }
 
 void ControlSystem::exitController()
@@ -4,18 +4,34 @@
 #include <Eigen/Dense>
 #include <functional>
 #include <optional>
+#include <array>
+#include <atomic>
 #include "../navigation/NS.hpp"
 #include "../navigation/environment.hpp"
 #include "mixers.hpp"
 #include "controller_mode.hpp"
 #include "controller_loop.hpp"
+#include "mode_registry.hpp"
+#include "loop_clock.hpp"
+#include "../loop_stats.hpp"
+#include "../seqlock.hpp"
 #include "common.hpp"
 #include "../communication/control.hpp"
+#include "../communication/metrics.hpp"
 
 
 class ControllerLoop;
 class Control;
 
+/// @brief Joystick axes received by order server and not applied yet
+struct JoystickInput
+{
+    /// @brief number of valid axes
+    int count = 0;
+    /// @brief axes deflection
+    std::array<double, def::MAX_JOYSTICK_AXES> axes{};
+};
+
 /// @brief Central controller class
 class ControlSystem
 {
@@ -33,25 +49,67 @@ class ControlSystem
         /// @brief Run controller
         void run();
 
-        /// @brief Change controller mode
+        /// @brief Change controller mode. Mode is switched at beginning of next control loop tick.
         /// @param new_mode new contoller mode
         void setMode(ControllerMode new_mode);
 
         /// @brief Stop controller loop
         void exitController();
 
+        /// @brief Queues joystick deflection. Active mode gets it at beginning of next control loop tick.
+        /// @param axes joystick axes, further than def::MAX_JOYSTICK_AXES are ignored
+        void queueJoystick(const Eigen::Ref<const Eigen::VectorXd>& axes);
+
+        /// @brief Returns demands of active mode published by last control loop tick. Safe to call from other thread.
+        /// @return mode and demand values
+        DemandInfo getDemands() const;
+
+        /// @brief Returns timing statistics of control and NS loops
+        /// @return statistics report
+        std::string timingReport() const;
+
     private:
-        ControllerLoop* controller_loop;
+        static constexpr int NO_MODE = -1;
+
+        /// @brief Active mode, points to one of modes
+        std::atomic<ControllerModes*> controller_loop;
+        /// @brief Mode requested by setMode and not applied yet, NO_MODE if none
+        std::atomic<int> pendingMode;
+        /// @brief Joystick input written by order server, applied by control loop
+        SeqLock<JoystickInput> joystick;
+        /// @brief Version of joystick input applied last. Used by control loop only.
+        std::uint64_t appliedJoystick;
+        /// @brief Demands of active mode after last tick, read by order server
+        SeqLock<DemandInfo> demands;
+        /// @brief Mode objects indexed by mode enum value, empty if mode misses controllers
+        std::array<std::optional<ControllerModes>, CONTROLLER_MODE_COUNT> modes;
         Control* control;
         Status status;
         Environment env;
         NS navisys;
-        std::optional<TimedLoop> loop;
+        LoopStats stats;
+        std::unique_ptr<LoopClock> loop;
         std::map<std::string,std::unique_ptr<Controller>> controllers;
+        std::unique_ptr<MetricsPublisher> metrics;
 
         /// @brief Starts controller loop
         void startLoop();
 
+        /// @brief One control step: navigation (if fused), pending mode switch and mode job
+        /// @param fused run navigation step before control
+        void runStep(bool fused);
+
+        /// @brief Switches active mode if one was requested. Called by control loop only.
+        void applyPendingMode();
+
+        /// @brief Passes joystick input queued since last tick to active mode. Called by control loop only.
+        /// @param active active mode
+        void applyJoystick(ControllerModes& active);
+
+        /// @brief Fills metrics message. Called from metrics publisher thread.
+        /// @param msg metrics message
+        void collectMetrics(metrics_msg::MetricsMsg& msg);
+
 
         /// @brief Synchronize start with physic engine
         /// @param ctx zero mq context
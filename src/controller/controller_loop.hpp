@@ -2,7 +2,9 @@
 
 #include <Eigen/Dense>
 #include <map>
+#include <array>
 #include "controller_mode.hpp"
+#include "../defines.hpp"
 #include "common.hpp"
 #include "mixers.hpp"
 #include "../communication/control.hpp"
@@ -10,7 +12,25 @@
 
 class Control;
 
-/// @brief This class is interface of controller modes. All modes should keep this strucure and implements all true virtual methods.
+/// @brief Actual demands of controller mode
+struct DemandInfo
+{
+    /// @brief mode that set demands
+    ControllerMode mode;
+    /// @brief number of valid values
+    int count;
+    /// @brief demand values, meaning depends on mode
+    std::array<double, def::MAX_DEMANDS> values;
+};
+
+/// @brief This class is base of controller modes. Modes are dispatched statically through ControllerModes variant,
+/// so mode hides methods it implements instead of overriding them. Every mode must be registered in mode_registry.hpp.
+/// Variant lets all modes be constructed once in place, so switching mode never allocates;
+/// call cost is the same as virtual call (see tools/dispatch_bench).
+///
+/// Every mode declares static constexpr ControllerMode MODE, equal to its alternative index in ControllerModes,
+/// and passes it to this constructor. Mode using controllers names them with private enum ControllerIndex,
+/// whose values follow order of required_controllers, and reads them through controller(index).
 class ControllerLoop
 {
 public:
@@ -18,68 +38,82 @@ public:
     /// @param mode mode enum value
     ControllerLoop(ControllerMode mode);
     
-    /// @brief Virtual deconstructor for defined behavior
-    virtual ~ControllerLoop() {}
+    ControllerLoop(const ControllerLoop&) = delete;
+    ControllerLoop& operator=(const ControllerLoop&) = delete;
 
 
-    /// @brief Controller job that will be called in control loop.
-    /// @param controllers map of aviliable controllers
+    /// @brief Controller job that will be called in control loop. Uses controllers bound by bindControllers.
     /// @param control reference to control instatce that is used to send control commands
     /// @param navisys navigation system reference
-    virtual void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
+    void job(
         [[maybe_unused]] Control& control,
         [[maybe_unused]] NS& navisys
         );
 
     /// @brief Handle incomming joystick deflaction
     /// @param joystick joystick axes deflaction
-    virtual void handleJoystick(
-        [[maybe_unused]] Eigen::VectorXd joystick
+    void handleJoystick(
+        [[maybe_unused]] const Eigen::Ref<const Eigen::VectorXd>& joystick
     ) 
     {};
 
-    /// @brief Prepare info about state and demands.
-    /// @return information about mode and actually set demands
-    virtual std::string demandInfo() 
+    /// @brief Returns actually set demands
+    /// @return mode and demand values
+    DemandInfo demands() 
     {
-        return ControllerModeToString(_mode);
+        return DemandInfo{_mode, 0, {}};
     }
 
+    /// @brief Prepare info about state and demands in text form.
+    /// @param info demands of mode
+    /// @return mode name followed by actually set demands, comma separated
+    static std::string demandInfo(const DemandInfo& info);
+
     /// @brief Defines controllers controller required by mode
     /// @return vector of names of required controllers
-    virtual const std::vector<std::string>& requiredcontrollers()
+    const std::vector<std::string>& requiredcontrollers()
     {
         return required_controllers;
     };
 
+    /// @brief Restores demands to initial values. Called when mode is activated, mode objects are reused.
+    void reset() {};
+
     /// @brief Overrides demands to apply to given postion, orientation and speed
     /// @param position position vector in world frame
     /// @param orientation orientation vector in world frame
     /// @param orientation linear velocity vector in world frame
-    virtual void overridePositionAndSpeed(
+    void overridePositionAndSpeed(
         [[maybe_unused]] Eigen::Vector3d position,
         [[maybe_unused]] Eigen::Vector3d orientation,
         [[maybe_unused]] Eigen::Vector3d velocity
     )
     {};
 
+    /// @brief Resolves required controllers to pointers, so job does not look them up by name
+    /// @param controllers map of aviliable controllers, must outlive this mode
+    /// @return false if any required controller is missing
+    bool bindControllers(std::map<std::string,std::unique_ptr<Controller>>& controllers);
+
     /// @brief Returns assigned mode enum value.
     /// @return mode enum value
     ControllerMode getMode() { return _mode; };
 
-    /// @brief ControllerLoop factor. Returns instace of ControllerLoop that implements specified mode
-    /// @param mode demanded mode
-    /// @return Pointer to dynamically alocated ControllerLoop
-    static ControllerLoop* ControllerLoopFactory(ControllerMode mode);
-
 protected:
     const ControllerMode _mode;
     std::vector<std::string> required_controllers;
 
+    /// @brief Returns controller bound by bindControllers
+    /// @param index position of controller in required_controllers
+    /// @return controller reference
+    Controller& controller(int index) { return *bound_controllers[index]; }
+
     /// @brief Check if joystick input vector is correct
     /// @param joystick joystick axes deflaction
     /// @param minimalSize minimal length of deflation vector that can be interpreted
     /// @return return true if joystick input vector is long enough
-    bool checkJoystickLength(const Eigen::VectorXd& joystick, const int minimalSize);
+    bool checkJoystickLength(const Eigen::Ref<const Eigen::VectorXd>& joystick, const int minimalSize);
+
+private:
+    std::vector<Controller*> bound_controllers;
 };
\ No newline at end of file
@@ -18,6 +18,9 @@ enum ControllerMode
     RGUIDED = 10
 };
 
+/// @brief Number of controller modes
+constexpr int CONTROLLER_MODE_COUNT = ControllerMode::RGUIDED + 1;
+
 /// @brief Serializes controller mode to string
 /// @param mode controller mode
 /// @return serialized mode
@@ -55,29 +58,29 @@ constexpr const char* ControllerModeToString(ControllerMode mode) throw()
 /// @brief Parse string to controller mode
 /// @param mode string to parse
 /// @return parsing result, NONE if parse failed
-constexpr ControllerMode  ControllerModeFromString(const char* mode) throw()
+constexpr ControllerMode  ControllerModeFromString(std::string_view mode) throw()
 {
-  if (std::string_view(mode) == "NONE")
+  if (mode == "NONE")
     return ControllerMode::NONE;
-  if (std::string_view(mode) == "QPOS")
+  if (mode == "QPOS")
     return ControllerMode::QPOS;
-  if (std::string_view(mode) == "QANGLE")
+  if (mode == "QANGLE")
     return ControllerMode::QANGLE;
-  if (std::string_view(mode) == "QACRO")
+  if (mode == "QACRO")
     return ControllerMode::QACRO;
-  if (std::string_view(mode) == "FMANUAL")
+  if (mode == "FMANUAL")
     return ControllerMode::FMANUAL;
-  if (std::string_view(mode) == "FACRO")
+  if (mode == "FACRO")
     return ControllerMode::FACRO;
-  if (std::string_view(mode) == "FANGLE")
+  if (mode == "FANGLE")
     return ControllerMode::FANGLE;
-  if (std::string_view(mode) == "RMANUAL")
+  if (mode == "RMANUAL")
     return ControllerMode::RMANUAL;
-  if (std::string_view(mode) == "RAUTOLAUNCH")
+  if (mode == "RAUTOLAUNCH")
     return ControllerMode::RAUTOLAUNCH;
-  if (std::string_view(mode) == "RANGLE")
+  if (mode == "RANGLE")
     return ControllerMode::RANGLE;
-  if (std::string_view(mode) == "RGUIDED")
+  if (mode == "RGUIDED")
     return ControllerMode::RGUIDED;
 
   std::cerr << "Unknown mode: " << mode << std::endl;
@@ -0,0 +1,39 @@
+#include "loop_clock.hpp"
+#include <chrono>
+#include <thread>
+
+WallClock::WallClock(int period, std::function<void(std::chrono::steady_clock::time_point)> tick, Status& status):
+    period{period}, tick{tick}, status{status}
+{}
+
+void WallClock::go()
+{
+    auto scheduled = std::chrono::steady_clock::now();
+    while(status == Status::running)
+    {
+        scheduled += period;
+        std::this_thread::sleep_until(scheduled);
+        tick(scheduled);
+        // Overrun skips ticks whose time already passed instead of running them back to back
+        const auto now = std::chrono::steady_clock::now();
+        while(scheduled + period <= now) scheduled += period;
+    }
+}
+
+SimulationStepClock::SimulationStepClock(Environment& env, std::function<void(std::uint64_t)> tick, Status& status):
+    env{env}, tick{tick}, status{status}, lastVersion{0}
+{}
+
+void SimulationStepClock::go()
+{
+    while(status == Status::running)
+    {
+        // Timeout only lets loop notice status change
+        std::uint64_t seq;
+        const std::uint64_t version = env.waitForState(lastVersion, std::chrono::milliseconds(100), seq);
+        if(version == lastVersion) continue;
+        lastVersion = version;
+        // Acknowledge step number given by simulator, also 0 after physics restart
+        tick(seq);
+    }
+}
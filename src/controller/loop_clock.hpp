@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include "common.hpp"
+#include "../navigation/environment.hpp"
+
+/// @brief Source of control loop ticks. Sensors and filters always use simulation time from Environment,
+/// clock only decides when next tick is run.
+class LoopClock
+{
+public:
+    /// @brief Virtual deconstructor for defined behavior
+    virtual ~LoopClock() {}
+
+    /// @brief Runs ticks until status is no longer running
+    virtual void go() = 0;
+};
+
+/// @brief Ticks paced by wall clock on fixed grid, late tick does not shift following ones
+class WallClock: public LoopClock
+{
+public:
+    /// @brief Constructor
+    /// @param period tick period in ms
+    /// @param tick function called every tick with its scheduled wake-up time
+    /// @param status controller status
+    WallClock(int period, std::function<void(std::chrono::steady_clock::time_point)> tick, Status& status);
+
+    void go() override;
+
+private:
+    std::chrono::milliseconds period;
+    std::function<void(std::chrono::steady_clock::time_point)> tick;
+    Status& status;
+};
+
+/// @brief Lockstep ticks, one per simulator step. Runs as fast as simulator publishes steps.
+class SimulationStepClock: public LoopClock
+{
+public:
+    /// @brief Constructor
+    /// @param env environment that publishes simulator steps
+    /// @param tick function called every step with step number
+    /// @param status controller status
+    SimulationStepClock(Environment& env, std::function<void(std::uint64_t)> tick, Status& status);
+
+    void go() override;
+
+private:
+    Environment& env;
+    std::function<void(std::uint64_t)> tick;
+    Status& status;
+    std::uint64_t lastVersion;
+};
@@ -1,40 +1,57 @@
 #include "mixers.hpp"
 #include <Eigen/Dense>
+#include <iostream>
 #include "common.hpp"
 
-Eigen::VectorXd applyMixerRotors(double climb_rate, double roll_rate , double pitch_rate, double yaw_rate)
+namespace {
+using RotorMatrix = Eigen::Matrix<double, Eigen::Dynamic, 4, 0, def::MAX_ROTORS, 4>;
+using SurfaceMatrix = Eigen::Matrix<double, Eigen::Dynamic, 4, 0, def::MAX_SURFACES, 4>;
+
+RotorMatrix rotorMatrix;
+RotorVector rotorMaxSpeed;
+RotorVector rotorHoverSpeed;
+SurfaceMatrix surfaceMatrix;
+}
+
+void initMixers()
 {
-    static const UAVparams* params = UAVparams::getSingleton();
-    static const auto rotorMatrix = params->rotorMixer;
-    static const auto rotorMaxSpeed = params->getRotorMaxSpeeds();
+    const UAVparams* params = UAVparams::getSingleton();
+    if(params->rotorMixer.rows() > def::MAX_ROTORS || params->surfaceMixer.rows() > def::MAX_SURFACES)
+    {
+        std::cerr << "Airframe exceeds mixer limits: " << def::MAX_ROTORS << " rotors, "
+            << def::MAX_SURFACES << " surfaces" << std::endl;
+        exit(1);
+    }
+    rotorMatrix = params->rotorMixer;
+    rotorMaxSpeed = params->getRotorMaxSpeeds();
+    rotorHoverSpeed = params->getRotorHoverSpeeds();
+    surfaceMatrix = params->surfaceMixer;
+}
 
+RotorVector applyMixerRotors(double climb_rate, double roll_rate , double pitch_rate, double yaw_rate)
+{
     Eigen::Vector4d u;
     u << climb_rate, roll_rate, pitch_rate, yaw_rate;
-    Eigen::VectorXd res = rotorMatrix*u;
+    RotorVector res;
+    res.noalias() = rotorMatrix.lazyProduct(u);
     return res.cwiseMax(0.0).cwiseMin(rotorMaxSpeed);
 }
 
-Eigen::VectorXd applyMixerRotorsHover(double throttle, double roll_rate, double pitch_rate, double yaw_rate)
+RotorVector applyMixerRotorsHover(double throttle, double roll_rate, double pitch_rate, double yaw_rate)
 {
-    static const UAVparams* params = UAVparams::getSingleton();
-    static const auto rotorMatrix = params->rotorMixer;
-    static const auto rotorMaxSpeed = params->getRotorMaxSpeeds();
-    static const auto rotorHoverSpeed = params->getRotorHoverSpeeds();
-
     Eigen::Vector4d u;
     u << 0.0, roll_rate, pitch_rate, yaw_rate;
-    Eigen::VectorXd res = rotorMatrix*u;
+    RotorVector res;
+    res.noalias() = rotorMatrix.lazyProduct(u);
     res+= (throttle + 1.0)*rotorHoverSpeed; 
     return res.cwiseMax(0.0).cwiseMin(rotorMaxSpeed);
 }
 
-Eigen::VectorXd applyMixerSurfaces(double throttle, double roll_rate, double pitch_rate, double yaw_rate)
+SurfaceVector applyMixerSurfaces(double throttle, double roll_rate, double pitch_rate, double yaw_rate)
 {
-    static const UAVparams* params = UAVparams::getSingleton();
-    static const auto surfaceMatrix = params->surfaceMixer;
-
     Eigen::Vector4d u;
     u << throttle, roll_rate, pitch_rate, yaw_rate;
-    Eigen::VectorXd res = surfaceMatrix*u; 
+    SurfaceVector res;
+    res.noalias() = surfaceMatrix.lazyProduct(u); 
     return res;
 }
@@ -1,6 +1,16 @@
 #pragma once
 #include <Eigen/Dense>
+#include "../defines.hpp"
 
+/// @brief Demanded rotors speed. Size is set at runtime, storage is fixed so it never allocates.
+using RotorVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, def::MAX_ROTORS, 1>;
+
+/// @brief Demanded surfaces deflection. Size is set at runtime, storage is fixed so it never allocates.
+using SurfaceVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, def::MAX_SURFACES, 1>;
+
+/// @brief Copies mixer matrices and rotor limits from UAV params into fixed size storage.
+/// Must be called once before any mixer is applied. Exits if airframe has too many rotors or surfaces.
+void initMixers();
 
 /// @brief Calculates rotor demanded speed as result of multiplication mixer matrix and rates. Average speed is proportional to climb rate
 /// @param climb_rate 
@@ -8,7 +18,7 @@
 /// @param pitch_rate 
 /// @param yaw_rate 
 /// @return Rotors demanded speed
-Eigen::VectorXd applyMixerRotors(double  climb_rate, double roll_rate , double pitch_rate, double yaw_rate);
+RotorVector applyMixerRotors(double  climb_rate, double roll_rate , double pitch_rate, double yaw_rate);
 
 /// @brief Calculates rotor demanded speed as result of multiplication mixer matrix and rates. Average speed is proportional to throttle.
 /// It's scaled to achieve hover at centered throttle
@@ -17,7 +27,7 @@ Eigen::VectorXd applyMixerRotors(double  climb_rate, double roll_rate , double p
 /// @param pitch_rate 
 /// @param yaw_rate 
 /// @return Rotors demanded speed
-Eigen::VectorXd applyMixerRotorsHover(double  throttle, double roll_rate , double pitch_rate, double yaw_rate);
+RotorVector applyMixerRotorsHover(double  throttle, double roll_rate , double pitch_rate, double yaw_rate);
 
 
 
@@ -27,4 +37,4 @@ Eigen::VectorXd applyMixerRotorsHover(double  throttle, double roll_rate , doubl
 /// @param pitch_rate 
 /// @param yaw_rate 
 /// @return demanded surfaces deflection
-Eigen::VectorXd applyMixerSurfaces(double  throttle, double roll_rate , double pitch_rate, double yaw_rate);
+SurfaceVector applyMixerSurfaces(double  throttle, double roll_rate , double pitch_rate, double yaw_rate);
@@ -0,0 +1,49 @@
+#pragma once
+#include <variant>
+#include <optional>
+#include <utility>
+#include "controller_mode.hpp"
+#include "modes/controller_loop_NONE.hpp"
+#include "modes/controller_loop_QPOS.hpp"
+#include "modes/controller_loop_QANGLE.hpp"
+#include "modes/controller_loop_QACRO.hpp"
+#include "modes/controller_loop_FMANUAL.hpp"
+#include "modes/controller_loop_FACRO.hpp"
+#include "modes/controller_loop_FANGLE.hpp"
+#include "modes/controller_loop_RMANUAL.hpp"
+#include "modes/controller_loop_RAUTOLAUNCH.hpp"
+#include "modes/controller_loop_RANGLE.hpp"
+#include "modes/controller_loop_RGUIDED.hpp"
+
+/// @brief All controller modes. Alternative index is equal to ControllerMode enum value,
+/// adding mode requires only enum value and entry here.
+using ControllerModes = std::variant<
+    ControllerLoopNONE,
+    ControllerLoopQPOS,
+    ControllerLoopQANGLE,
+    ControllerLoopQACRO,
+    ControllerLoopFMANUAL,
+    ControllerLoopFACRO,
+    ControllerLoopFANGLE,
+    ControllerLoopRMANUAL,
+    ControllerLoopRAUTOLAUNCH,
+    ControllerLoopRANGLE,
+    ControllerLoopRGUIDED
+>;
+
+static_assert(std::variant_size_v<ControllerModes> == CONTROLLER_MODE_COUNT, "Every controller mode must be registered");
+static_assert([]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return ((std::variant_alternative_t<I, ControllerModes>::MODE == static_cast<ControllerMode>(I)) && ...);
+    }(std::make_index_sequence<CONTROLLER_MODE_COUNT>{}), "Mode alternative index must match its MODE");
+
+/// @brief Constructs mode object in place, mode objects can not be moved
+/// @param slot storage of mode
+/// @param mode demanded mode
+inline void emplaceControllerMode(std::optional<ControllerModes>& slot, ControllerMode mode)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        ((I == static_cast<std::size_t>(mode) ? (slot.emplace(std::in_place_index<I>), true) : false) || ...);
+    }(std::make_index_sequence<std::variant_size_v<ControllerModes>>{});
+}
@@ -2,30 +2,30 @@
 #include "../../utils.hpp"
 
 ControllerLoopFACRO::ControllerLoopFACRO():
-    ControllerLoop(ControllerMode::FACRO)
+    ControllerLoop(MODE)
 {
     required_controllers.assign({"Roll", "Pitch", "Yaw"});
 }
 
 void ControllerLoopFACRO::job(
-    [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     [[maybe_unused]] NS& navisys
 ) 
 {
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d angVel = nav.angularVelocity;
 
-    double roll_rate = controllers.at("Roll")->calc(demanded_P, angVel(0));
-    double pitch_rate = controllers.at("Pitch")->calc(demanded_Q,angVel(1));
-    double yaw_rate = controllers.at("Yaw")->calc(demanded_R,angVel(2));
+    double roll_rate = controller(ROLL).calc(demanded_P, angVel(0));
+    double pitch_rate = controller(PITCH).calc(demanded_Q,angVel(1));
+    double yaw_rate = controller(YAW).calc(demanded_R,angVel(2));
 
-    Eigen::VectorXd vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
+    RotorVector vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
     control.sendSpeed(vec);
-    Eigen::VectorXd surf = applyMixerSurfaces(throttle,roll_rate,pitch_rate,yaw_rate);
+    SurfaceVector surf = applyMixerSurfaces(throttle,roll_rate,pitch_rate,yaw_rate);
     control.sendSurface(surf);
 }
 
-void ControllerLoopFACRO::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopFACRO::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     if(!checkJoystickLength(joystick,4)) return;
     throttle   = joystick[0];
@@ -34,11 +34,19 @@ void ControllerLoopFACRO::handleJoystick(Eigen::VectorXd joystick)
     demanded_R = joystick[3]*3.0;
 }
 
-std::string ControllerLoopFACRO::demandInfo() {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << demanded_P << "," << demanded_Q << "," << demanded_R;
-    return ss.str();
+DemandInfo ControllerLoopFACRO::demands() 
+{
+    DemandInfo info{_mode, 3, {}};
+    info.values[0] = demanded_P;
+    info.values[1] = demanded_Q;
+    info.values[2] = demanded_R;
+    return info;
+}
+
+void ControllerLoopFACRO::reset()
+{
+    demanded_P = 0.0;
+    demanded_Q = 0.0;
+    demanded_R = 0.0;
+    throttle = 0.0;
 }
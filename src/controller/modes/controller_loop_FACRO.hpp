@@ -4,18 +4,23 @@
 class ControllerLoopFACRO: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::FACRO;
+
     ControllerLoopFACRO();
 
     void job(
-        std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        NS& navisys) override;
+        NS& navisys);
         
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
+
+    DemandInfo demands();
 
-    std::string demandInfo() override;
+    void reset();
 
 private:
+    enum ControllerIndex { ROLL, PITCH, YAW };
+
     std::atomic<double> demanded_P = 0.0;
     std::atomic<double> demanded_Q = 0.0;
     std::atomic<double> demanded_R = 0.0;
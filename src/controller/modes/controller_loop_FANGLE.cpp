@@ -2,48 +2,48 @@
 #include "../../utils.hpp"
 
 ControllerLoopFANGLE::ControllerLoopFANGLE():
-    ControllerLoop(ControllerMode::FANGLE)
+    ControllerLoop(MODE)
 {
     required_controllers.assign({"Roll", "Pitch", "Yaw", "U", "Fi", "Theta", "Psi"});
 }
 
 void ControllerLoopFANGLE::job(
-    std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     NS& navisys
 ) 
 {
-    Eigen::Vector3d vel = navisys.getRotationMatrixBodyToWorld().transpose() *  navisys.getLinearVelocity();
-    Eigen::Vector3d ori = navisys.getOrientation();
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d vel = nav.R_bw.transpose() *  nav.linearVelocity;
+    Eigen::Vector3d ori = nav.orientation;
+    Eigen::Vector3d angVel = nav.angularVelocity;
 
-    double demandedP = controllers.at("Fi")->calc(circularError(demandedFi, ori(0)), 0.0);
-    double demandedQ = controllers.at("Theta")->calc(circularError(demandedTheta, ori(1)), 0.0);
+    double demandedP = controller(FI).calc(circularError(demandedFi, ori(0)), 0.0);
+    double demandedQ = controller(THETA).calc(circularError(demandedTheta, ori(1)), 0.0);
 
-    double throttle = controllers.at("U")->calc(demandedVx, vel(0));
-    double roll_rate = controllers.at("Roll")->calc(demandedP, angVel(0));
-    double pitch_rate = controllers.at("Pitch")->calc(demandedQ ,angVel(1));
+    double throttle = controller(U).calc(demandedVx, vel(0));
+    double roll_rate = controller(ROLL).calc(demandedP, angVel(0));
+    double pitch_rate = controller(PITCH).calc(demandedQ ,angVel(1));
     double yaw_rate = 0.0;
 
     // Disable rudder when plane tilted
     if(std::abs(ori(0)) > angleLimit/2 )
     {
         demandedPsi = ori(2);
-        yaw_rate = controllers.at("Yaw")->calc(demanded_R, angVel(2));
+        yaw_rate = controller(YAW).calc(demanded_R, angVel(2));
     }
     else
     {
-        double demandedR = controllers.at("Psi")->calc(circularError(demandedPsi, ori(2)), 0.0);
-        yaw_rate = controllers.at("Yaw")->calc(demandedR, angVel(2));
+        double demandedR = controller(PSI).calc(circularError(demandedPsi, ori(2)), 0.0);
+        yaw_rate = controller(YAW).calc(demandedR, angVel(2));
     }
 
-    Eigen::VectorXd vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
+    RotorVector vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
     control.sendSpeed(vec);
-    Eigen::VectorXd surf = applyMixerSurfaces(throttle,roll_rate,pitch_rate,yaw_rate);
+    SurfaceVector surf = applyMixerSurfaces(throttle,roll_rate,pitch_rate,yaw_rate);
     control.sendSurface(surf);
 }
 
-void ControllerLoopFANGLE::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopFANGLE::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     if(!checkJoystickLength(joystick,4)) return;
     demandedVx += joystick[0]/2.0;
@@ -54,14 +54,14 @@ void ControllerLoopFANGLE::handleJoystick(Eigen::VectorXd joystick)
     demanded_R = joystick[3]*3.0;
 }
 
-std::string ControllerLoopFANGLE::demandInfo() 
+DemandInfo ControllerLoopFANGLE::demands() 
 {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << demandedFi << "," << demandedTheta << "," << demandedPsi << "," << demandedVx;
-    return ss.str();
+    DemandInfo info{_mode, 4, {}};
+    info.values[0] = demandedFi;
+    info.values[1] = demandedTheta;
+    info.values[2] = demandedPsi;
+    info.values[3] = demandedVx;
+    return info;
 }
 
 void ControllerLoopFANGLE::overridePositionAndSpeed(
@@ -73,3 +73,12 @@ void ControllerLoopFANGLE::overridePositionAndSpeed(
     demandedVx = velocity.x();
     demandedPsi = orientation.z();
 }
+
+void ControllerLoopFANGLE::reset()
+{
+    demandedVx = 0.0;
+    demandedFi = 0.0;
+    demandedTheta = 0.0;
+    demandedPsi = 0.0;
+    demanded_R = 0.0;
+}
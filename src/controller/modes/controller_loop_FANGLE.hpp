@@ -4,26 +4,31 @@
 class ControllerLoopFANGLE: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::FANGLE;
+
     ControllerLoopFANGLE();
 
     void job(
-        std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        NS& navisys) override;
+        NS& navisys);
         
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
 
-    std::string demandInfo() override;
+    DemandInfo demands();
 
     void overridePositionAndSpeed(
         [[maybe_unused]] Eigen::Vector3d position,
         [[maybe_unused]] Eigen::Vector3d orientation,
         [[maybe_unused]] Eigen::Vector3d velocity
-    ) override;
+    );
 
     static constexpr double angleLimit = std::numbers::pi/2.0;
 
+    void reset();
+
 private:
+    enum ControllerIndex { ROLL, PITCH, YAW, U, FI, THETA, PSI };
+
     std::atomic<double> demandedVx = 0.0;
     std::atomic<double> demandedFi = 0.0;
     std::atomic<double> demandedTheta = 0.0;
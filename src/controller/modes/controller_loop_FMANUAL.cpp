@@ -1,25 +1,24 @@
 #include "controller_loop_FMANUAL.hpp"
 
 ControllerLoopFMANUAL::ControllerLoopFMANUAL():
-    ControllerLoop(ControllerMode::FMANUAL)
+    ControllerLoop(MODE)
 {
     required_controllers.clear();
 }
 
 void ControllerLoopFMANUAL::job(
-    [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     [[maybe_unused]] NS& navisys
 ) 
 {
 
-    Eigen::VectorXd vec = applyMixerRotorsHover(throttle,demanded_P_rate,demanded_Q_rate,demanded_R_rate);
+    RotorVector vec = applyMixerRotorsHover(throttle,demanded_P_rate,demanded_Q_rate,demanded_R_rate);
     control.sendSpeed(vec);
-    Eigen::VectorXd surf = applyMixerSurfaces(throttle,demanded_P_rate,demanded_Q_rate,demanded_R_rate);
+    SurfaceVector surf = applyMixerSurfaces(throttle,demanded_P_rate,demanded_Q_rate,demanded_R_rate);
     control.sendSurface(surf);
 }
 
-void ControllerLoopFMANUAL::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopFMANUAL::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     if(!checkJoystickLength(joystick,4)) return;
     throttle = joystick[0];
@@ -27,3 +26,11 @@ void ControllerLoopFMANUAL::handleJoystick(Eigen::VectorXd joystick)
     demanded_Q_rate = -joystick[2];
     demanded_R_rate = joystick[3];
 }
+
+void ControllerLoopFMANUAL::reset()
+{
+    demanded_P_rate = 0.0;
+    demanded_Q_rate = 0.0;
+    demanded_R_rate = 0.0;
+    throttle = 0.0;
+}
@@ -4,14 +4,17 @@
 class ControllerLoopFMANUAL: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::FMANUAL;
+
     ControllerLoopFMANUAL();
 
     void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        [[maybe_unused]] NS& navisys) override;
+        [[maybe_unused]] NS& navisys);
         
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
+
+    void reset();
 
 private:
     std::atomic<double> demanded_P_rate = 0.0;
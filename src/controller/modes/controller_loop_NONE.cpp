@@ -1,5 +1,5 @@
 #include "controller_loop_NONE.hpp"
 
 ControllerLoopNONE::ControllerLoopNONE():
-    ControllerLoop(ControllerMode::NONE)
+    ControllerLoop(MODE)
 {}
\ No newline at end of file
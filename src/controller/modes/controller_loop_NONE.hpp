@@ -5,5 +5,7 @@
 class ControllerLoopNONE: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::NONE;
+
     ControllerLoopNONE();
 };
\ No newline at end of file
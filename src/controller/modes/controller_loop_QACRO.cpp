@@ -1,28 +1,28 @@
 #include "controller_loop_QACRO.hpp"
 
 ControllerLoopQACRO::ControllerLoopQACRO():
-    ControllerLoop(ControllerMode::QACRO)
+    ControllerLoop(MODE)
 {
     required_controllers.assign({"Roll", "Pitch", "Yaw"});
 }
 
 void ControllerLoopQACRO::job(
-    std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     NS& navisys
 ) 
 {
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d angVel = nav.angularVelocity;
 
-    double roll_rate = controllers.at("Roll")->calc(demandedP, angVel(0));
-    double pitch_rate = controllers.at("Pitch")->calc(demandedQ, angVel(1));
-    double yaw_rate = controllers.at("Yaw")->calc(demandedR, angVel(2));
+    double roll_rate = controller(ROLL).calc(demandedP, angVel(0));
+    double pitch_rate = controller(PITCH).calc(demandedQ, angVel(1));
+    double yaw_rate = controller(YAW).calc(demandedR, angVel(2));
 
-    Eigen::VectorXd vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
+    RotorVector vec = applyMixerRotorsHover(throttle,roll_rate,pitch_rate,yaw_rate);
     control.sendSpeed(vec);
 }
 
-void ControllerLoopQACRO::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopQACRO::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     if(!checkJoystickLength(joystick,4)) return;
     throttle = joystick[0];
@@ -31,11 +31,20 @@ void ControllerLoopQACRO::handleJoystick(Eigen::VectorXd joystick)
     demandedR = joystick[3]*3.0;
 }
 
-std::string ControllerLoopQACRO::demandInfo() {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << demandedP << "," << demandedQ << "," << demandedR << "," << throttle;
-    return ss.str();
+DemandInfo ControllerLoopQACRO::demands() 
+{
+    DemandInfo info{_mode, 4, {}};
+    info.values[0] = demandedP;
+    info.values[1] = demandedQ;
+    info.values[2] = demandedR;
+    info.values[3] = throttle;
+    return info;
+}
+
+void ControllerLoopQACRO::reset()
+{
+    demandedP = 0.0;
+    demandedQ = 0.0;
+    demandedR = 0.0;
+    throttle = 0.0;
 }
@@ -4,18 +4,23 @@
 class ControllerLoopQACRO: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::QACRO;
+
     ControllerLoopQACRO();
 
     void job(
-        std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        NS& navisys) override;
+        NS& navisys);
         
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
+
+    DemandInfo demands();
 
-    std::string demandInfo() override;
+    void reset();
 
 private:
+    enum ControllerIndex { ROLL, PITCH, YAW };
+
     std::atomic<double> demandedP = 0.0;
     std::atomic<double> demandedQ = 0.0;
     std::atomic<double> demandedR = 0.0;
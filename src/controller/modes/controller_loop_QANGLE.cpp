@@ -2,37 +2,37 @@
 #include "../../utils.hpp"
 
 ControllerLoopQANGLE::ControllerLoopQANGLE():
-    ControllerLoop(ControllerMode::QANGLE)
+    ControllerLoop(MODE)
 {
     required_controllers.assign({"Roll", "Pitch", "Yaw", "W", "Z", "Fi", "Theta", "Psi"});
 }
 
 void ControllerLoopQANGLE::job(
-    std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     NS& navisys
 ) 
 {
-    Eigen::Vector3d pos = navisys.getPosition();
-    Eigen::Vector3d vel = navisys.getLinearVelocity();
-    Eigen::Vector3d ori = navisys.getOrientation();
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
-
-    double demandedW = controllers.at("Z")->calc(demandedZ, pos(2));
-    double demandedP = controllers.at("Fi")->calc(circularError(demandedFi, ori(0)), 0.0);
-    double demandedQ = controllers.at("Theta")->calc(circularError(demandedTheta, ori(1)), 0.0);
-    double demandedR = controllers.at("Psi")->calc(circularError(demandedPsi, ori(2)), 0.0);
-
-    double climb_rate = controllers.at("W")->calc(demandedW, vel(2));
-    double roll_rate = controllers.at("Roll")->calc(demandedP, angVel(0));
-    double pitch_rate = controllers.at("Pitch")->calc(demandedQ, angVel(1));
-    double yaw_rate = controllers.at("Yaw")->calc(demandedR, angVel(2));
-
-    Eigen::VectorXd vec = applyMixerRotors(climb_rate,roll_rate,pitch_rate,yaw_rate);
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d pos = nav.position;
+    Eigen::Vector3d vel = nav.linearVelocity;
+    Eigen::Vector3d ori = nav.orientation;
+    Eigen::Vector3d angVel = nav.angularVelocity;
+
+    double demandedW = controller(Z).calc(demandedZ, pos(2));
+    double demandedP = controller(FI).calc(circularError(demandedFi, ori(0)), 0.0);
+    double demandedQ = controller(THETA).calc(circularError(demandedTheta, ori(1)), 0.0);
+    double demandedR = controller(PSI).calc(circularError(demandedPsi, ori(2)), 0.0);
+
+    double climb_rate = controller(W).calc(demandedW, vel(2));
+    double roll_rate = controller(ROLL).calc(demandedP, angVel(0));
+    double pitch_rate = controller(PITCH).calc(demandedQ, angVel(1));
+    double yaw_rate = controller(YAW).calc(demandedR, angVel(2));
+
+    RotorVector vec = applyMixerRotors(climb_rate,roll_rate,pitch_rate,yaw_rate);
     control.sendSpeed(vec);
 }
 
-void ControllerLoopQANGLE::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopQANGLE::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     constexpr double angleLimit = std::numbers::pi/9.0;
     if(!checkJoystickLength(joystick,4)) return;
@@ -42,14 +42,14 @@ void ControllerLoopQANGLE::handleJoystick(Eigen::VectorXd joystick)
     demandedPsi = clampAngle(demandedPsi + joystick[3]/30.0);
 }
 
-std::string ControllerLoopQANGLE::demandInfo() 
+DemandInfo ControllerLoopQANGLE::demands() 
 {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << demandedFi << "," << demandedTheta << "," << demandedPsi << "," << demandedZ;
-    return ss.str();
+    DemandInfo info{_mode, 4, {}};
+    info.values[0] = demandedFi;
+    info.values[1] = demandedTheta;
+    info.values[2] = demandedPsi;
+    info.values[3] = demandedZ;
+    return info;
 }
 
 void ControllerLoopQANGLE::overridePositionAndSpeed(
@@ -61,3 +61,11 @@ void ControllerLoopQANGLE::overridePositionAndSpeed(
     demandedZ = position.z();
     demandedPsi = orientation.z();
 }
+
+void ControllerLoopQANGLE::reset()
+{
+    demandedZ = 0.0;
+    demandedFi = 0.0;
+    demandedTheta = 0.0;
+    demandedPsi = 0.0;
+}
@@ -2,49 +2,49 @@
 #include "../../utils.hpp"
 
 ControllerLoopQPOS::ControllerLoopQPOS():
-    ControllerLoop(ControllerMode::QPOS)
+    ControllerLoop(MODE)
 {
     required_controllers.assign({"Roll", "Pitch", "Yaw", "W", "Z", "Fi",
         "Theta", "Psi", "X", "Y", "V", "U"});
 }
 
 void ControllerLoopQPOS::job(
-    std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     NS& navisys
 ) 
 {
-    Eigen::Vector3d pos = navisys.getPosition();
-    Eigen::Vector3d vel = navisys.getLinearVelocity();
-    Eigen::Vector3d ori = navisys.getOrientation();
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d pos = nav.position;
+    Eigen::Vector3d vel = nav.linearVelocity;
+    Eigen::Vector3d ori = nav.orientation;
+    Eigen::Vector3d angVel = nav.angularVelocity;
 
-    double demandedU = controllers.at("X")->calc(demandedX, pos(0));
-    double demandedV = controllers.at("Y")->calc(demandedY, pos(1));
+    double demandedU = controller(X).calc(demandedX, pos(0));
+    double demandedV = controller(Y).calc(demandedY, pos(1));
     
-    double demandedFi_star = controllers.at("V")->calc(demandedV, vel(1));
-    double demandedTheta_star = controllers.at("U")->calc(demandedU, vel(0));
+    double demandedFi_star = controller(V).calc(demandedV, vel(1));
+    double demandedTheta_star = controller(U).calc(demandedU, vel(0));
 
     double PsiCos = std::cos(ori(2));
     double PsiSin = std::sin(ori(2));
     double demandedFi = demandedFi_star*PsiCos + demandedTheta_star*PsiSin;
     double demandedTheta = - demandedFi_star*PsiSin + demandedTheta_star*PsiCos;
 
-    double demandedW = controllers.at("Z")->calc(demandedZ, pos(2));
-    double demandedP = controllers.at("Fi")->calc(circularError(demandedFi, ori(0)), 0.0);
-    double demandedQ = controllers.at("Theta")->calc(circularError(demandedTheta, ori(1)), 0.0);
-    double demandedR = controllers.at("Psi")->calc(circularError(demandedPsi, ori(2)), 0.0);
+    double demandedW = controller(Z).calc(demandedZ, pos(2));
+    double demandedP = controller(FI).calc(circularError(demandedFi, ori(0)), 0.0);
+    double demandedQ = controller(THETA).calc(circularError(demandedTheta, ori(1)), 0.0);
+    double demandedR = controller(PSI).calc(circularError(demandedPsi, ori(2)), 0.0);
 
-    double climb_rate = controllers.at("W")->calc(demandedW, vel(2));
-    double roll_rate = controllers.at("Roll")->calc(demandedP, angVel(0));
-    double pitch_rate = controllers.at("Pitch")->calc(demandedQ, angVel(1));
-    double yaw_rate = controllers.at("Yaw")->calc(demandedR, angVel(2));
+    double climb_rate = controller(W).calc(demandedW, vel(2));
+    double roll_rate = controller(ROLL).calc(demandedP, angVel(0));
+    double pitch_rate = controller(PITCH).calc(demandedQ, angVel(1));
+    double yaw_rate = controller(YAW).calc(demandedR, angVel(2));
 
-    Eigen::VectorXd vec = applyMixerRotors(climb_rate,roll_rate,pitch_rate,yaw_rate);
+    RotorVector vec = applyMixerRotors(climb_rate,roll_rate,pitch_rate,yaw_rate);
     control.sendSpeed(vec);
 }
 
-void ControllerLoopQPOS::handleJoystick(Eigen::VectorXd joystick) 
+void ControllerLoopQPOS::handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick) 
 {
     constexpr double angleLimit = std::numbers::pi/5.0;
     if(!checkJoystickLength(joystick,4)) return;
@@ -54,13 +54,14 @@ void ControllerLoopQPOS::handleJoystick(Eigen::VectorXd joystick)
     demandedY += ((joystick[2]*angleLimit)*std::sin(demandedPsi) + (joystick[1]*angleLimit)*std::cos(demandedPsi))/2.0;
 }
 
-std::string ControllerLoopQPOS::demandInfo() {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << demandedX << "," << demandedY << "," << demandedZ << "," << demandedPsi;
-    return ss.str();
+DemandInfo ControllerLoopQPOS::demands() 
+{
+    DemandInfo info{_mode, 4, {}};
+    info.values[0] = demandedX;
+    info.values[1] = demandedY;
+    info.values[2] = demandedZ;
+    info.values[3] = demandedPsi;
+    return info;
 }
 
 void ControllerLoopQPOS::overridePositionAndSpeed(
@@ -74,3 +75,11 @@ void ControllerLoopQPOS::overridePositionAndSpeed(
     demandedZ = position.z();
     demandedPsi = orientation.z();
 }
+
+void ControllerLoopQPOS::reset()
+{
+    demandedX = 0.0;
+    demandedY = 0.0;
+    demandedZ = 0.0;
+    demandedPsi = 0.0;
+}
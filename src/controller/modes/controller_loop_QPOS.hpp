@@ -4,24 +4,29 @@
 class ControllerLoopQPOS: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::QPOS;
+
     ControllerLoopQPOS();
 
     void job(
-        std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        NS& navisys) override;
+        NS& navisys);
 
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
 
-    std::string demandInfo() override;
+    DemandInfo demands();
 
     void overridePositionAndSpeed(
     [[maybe_unused]] Eigen::Vector3d position,
     [[maybe_unused]] Eigen::Vector3d orientation,
     [[maybe_unused]] Eigen::Vector3d velocity
-    ) override;
+    );
+
+    void reset();
 
 private:
+    enum ControllerIndex { ROLL, PITCH, YAW, W, Z, FI, THETA, PSI, X, Y, V, U };
+
     std::atomic<double> demandedX = 0.0;
     std::atomic<double> demandedY = 0.0;
     std::atomic<double> demandedZ = 0.0;
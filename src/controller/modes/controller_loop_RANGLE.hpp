@@ -4,24 +4,29 @@
 class ControllerLoopRANGLE: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::RANGLE;
+
     ControllerLoopRANGLE();
 
     void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        [[maybe_unused]] NS& navisys) override;
+        [[maybe_unused]] NS& navisys);
 
-    void handleJoystick(Eigen::VectorXd joystick) override;
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
 
-    std::string demandInfo() override;
+    DemandInfo demands();
 
     void overridePositionAndSpeed(
         [[maybe_unused]] Eigen::Vector3d position,
         [[maybe_unused]] Eigen::Vector3d orientation,
         [[maybe_unused]] Eigen::Vector3d velocity
-    ) override;
+    );
+
+    void reset();
 
 protected:
+    enum ControllerIndex { H, V, THETA, PSI };
+
     std::atomic<double> demandedTheta = 0.0;
     std::atomic<double> demandedPsi = 0.0;
 
@@ -1,17 +1,15 @@
 #include "controller_loop_RAUTOLAUNCH.hpp"
 
 ControllerLoopRAUTOLAUNCH::ControllerLoopRAUTOLAUNCH():
-    ControllerLoop(ControllerMode::RAUTOLAUNCH)
+    ControllerLoop(MODE)
 {
 }
 
 void ControllerLoopRAUTOLAUNCH::job(
-    [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     [[maybe_unused]] NS& navisys
 ) 
 {
-    static bool running = false;
     if(!running)
     {
         control.startJet(0);
@@ -23,3 +21,7 @@ void ControllerLoopRAUTOLAUNCH::job(
     }
 }
 
+void ControllerLoopRAUTOLAUNCH::reset()
+{
+    running = false;
+}
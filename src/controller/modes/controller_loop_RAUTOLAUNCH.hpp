@@ -4,12 +4,16 @@
 class ControllerLoopRAUTOLAUNCH: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::RAUTOLAUNCH;
+
     ControllerLoopRAUTOLAUNCH();
 
     void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        [[maybe_unused]] NS& navisys) override;
+        [[maybe_unused]] NS& navisys);
+
+    void reset();
 
 protected:
+    bool running = false;
 };
\ No newline at end of file
@@ -3,28 +3,28 @@
 #include "common.hpp"
 
 ControllerLoopRGUIDED::ControllerLoopRGUIDED():
-    ControllerLoop(ControllerMode::RGUIDED), target{UAVparams::getSingleton()->target}
+    ControllerLoop(MODE), target{UAVparams::getSingleton()->target}
 {
     required_controllers.assign({"H", "V", "Theta", "Psi"});
 }
 
 void ControllerLoopRGUIDED::job(
-    [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
     Control& control,
     [[maybe_unused]] NS& navisys
 ) 
 {
-    Eigen::Vector3d pos = navisys.getPosition();
-    Eigen::Vector3d ori = navisys.getOrientation();
-    Eigen::Vector3d vel = navisys.getLinearVelocity();
-    Eigen::Vector3d angVel = navisys.getAngularVelocity();
+    const NavigationSolution nav = navisys.getSolution();
+    Eigen::Vector3d pos = nav.position;
+    Eigen::Vector3d ori = nav.orientation;
+    Eigen::Vector3d vel = nav.linearVelocity;
+    Eigen::Vector3d angVel = nav.angularVelocity;
 
     Eigen::Vector3d target_heading = target - pos;
 
     if(target_heading.norm() < 10.0)
     {
         std::cout << "Target reached" << std::endl;
-        Eigen::VectorXd surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
+        SurfaceVector surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
         control.sendSurface(surf);
         control.setMode(ControllerMode::RMANUAL);
     }
@@ -54,7 +54,7 @@ void ControllerLoopRGUIDED::job(
         || std::abs(circularError(demandedPsi, ori(2)) > detection_limit))
     {
         std::cout << "Target lost" << std::endl;
-        Eigen::VectorXd surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
+        SurfaceVector surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
         control.sendSurface(surf);
         control.setMode(ControllerMode::RMANUAL);
     }
@@ -81,30 +81,29 @@ void ControllerLoopRGUIDED::job(
     }
 
 
-    double demanded_V = controllers.at("Theta")->calc(circularError(demandedTheta, vel_theta), 0.0);
-    double demanded_H = controllers.at("Psi")->calc(circularError(demandedPsi, vel_psi), 0.0);
+    double demanded_V = controller(THETA).calc(circularError(demandedTheta, vel_theta), 0.0);
+    double demanded_H = controller(PSI).calc(circularError(demandedPsi, vel_psi), 0.0);
 
-    double V_rate = controllers.at("V")->calc(demanded_V,angVel(1));
-    double H_rate = controllers.at("H")->calc(demanded_H,angVel(2));
+    double V_rate = controller(V).calc(demanded_V,angVel(1));
+    double H_rate = controller(H).calc(demanded_H,angVel(2));
 
     if(std::abs(angVel(0)) < 3.0)
     {
-        Eigen::VectorXd surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
+        SurfaceVector surf = applyMixerSurfaces(0.0, 0.0, 0.0, 0.0);
         control.sendSurface(surf);
         return;
     }
     double est_roll = ori(0);
     double rot_pitch = V_rate * cos(est_roll) + H_rate * sin(est_roll);
-    Eigen::VectorXd surf = applyMixerSurfaces(0.0, 0.0, rot_pitch, 0.0);
+    SurfaceVector surf = applyMixerSurfaces(0.0, 0.0, rot_pitch, 0.0);
     control.sendSurface(surf);
 }
 
-std::string ControllerLoopRGUIDED::demandInfo() 
+DemandInfo ControllerLoopRGUIDED::demands() 
 {
-    std::stringstream ss;
-    std::string s;
-    ss.precision(3);
-    ss << std::fixed << ControllerModeToString(_mode) << ",";
-    ss << target.x() << "," << target.y() << "," << target.z();
-    return ss.str();
+    DemandInfo info{_mode, 3, {}};
+    info.values[0] = target.x();
+    info.values[1] = target.y();
+    info.values[2] = target.z();
+    return info;
 }
@@ -4,16 +4,19 @@
 class ControllerLoopRGUIDED: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::RGUIDED;
+
     ControllerLoopRGUIDED();
 
     void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        [[maybe_unused]] NS& navisys) override;
+        [[maybe_unused]] NS& navisys);
 
-    std::string demandInfo() override;
+    DemandInfo demands();
 
 protected:
+    enum ControllerIndex { H, V, THETA, PSI };
+
     const Eigen::Vector3d target;
     
     static constexpr double detection_limit = std::numbers::pi/3.0;
@@ -4,16 +4,20 @@
 class ControllerLoopRMANUAL: public ControllerLoop
 {
 public:
+    static constexpr ControllerMode MODE = ControllerMode::RMANUAL;
+
     ControllerLoopRMANUAL();
 
     void job(
-        [[maybe_unused]] std::map<std::string,std::unique_ptr<Controller>>& controllers,
         Control& control,
-        [[maybe_unused]] NS& navisys) override;
-    void handleJoystick(Eigen::VectorXd joystick) override;
-    std::string demandInfo() override;
+        [[maybe_unused]] NS& navisys);
+    void handleJoystick(const Eigen::Ref<const Eigen::VectorXd>& joystick);
+
+    void reset();
 
 protected:
+    enum ControllerIndex { H, V };
+
     std::atomic<double> demanded_H = 0.0;
     std::atomic<double> demanded_V = 0.0;
 };
\ No newline at end of file
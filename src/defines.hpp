@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 #define USE_QUATERIONS 1
 
@@ -7,4 +8,25 @@ namespace def {
 
 /// @brief How often send demands in response to stick command
 const int INFO_PERIOD = 2;
+
+/// @brief Maximal number of commands sent to physic engine and not acknowledged yet
+const int COMMAND_WINDOW = 8;
+
+/// @brief Time after which unacknowledged commands are considered lost and free the window, in ms
+const int ACK_TIMEOUT_MS = 1000;
+
+/// @brief Maximal number of joystick axes in single message, further axes are ignored
+const int MAX_JOYSTICK_AXES = 16;
+
+/// @brief Maximal number of demand values reported by controller mode
+const int MAX_DEMANDS = 8;
+
+/// @brief Maximal number of rotors supported by mixers
+const int MAX_ROTORS = 16;
+
+/// @brief Maximal number of control surfaces supported by mixers
+const int MAX_SURFACES = 16;
+
+/// @brief Maximal length of actuator command, equal to slot size of shared memory command ring
+const std::size_t COMMAND_BUFFER_SIZE = 1024;
 }
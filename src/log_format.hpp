@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// @brief Binary log file written by asynchronous logger and read by log_to_csv tool.
+/// File starts with MAGIC followed by records. Every record starts with RecordType byte.
+namespace log_format {
+
+/// @brief File signature
+constexpr char MAGIC[8] = {'U','A','V','B','L','O','G','1'};
+
+/// @brief Maximal number of values in one data record
+constexpr std::size_t MAX_VALUES = 32;
+
+/// @brief Type of record
+enum RecordType : std::uint8_t
+{
+    /// @brief channel definition, followed by name and header of CSV file
+    CHANNEL = 1,
+    /// @brief one CSV row, followed by values
+    DATA = 2
+};
+
+#pragma pack(push, 1)
+/// @brief Definition of channel (one CSV file). Repeated if header changes, last one is valid.
+struct ChannelHeader
+{
+    std::uint8_t type;
+    std::uint16_t channel;
+    /// @brief length of file name following header
+    std::uint16_t nameLen;
+    /// @brief length of CSV header following file name
+    std::uint16_t fmtLen;
+};
+
+/// @brief Row of channel, followed by count doubles
+struct DataHeader
+{
+    std::uint8_t type;
+    std::uint16_t channel;
+    std::uint8_t count;
+    double time;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(double) == 8, "Log format requires IEEE-754 double");
+}
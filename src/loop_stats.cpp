@@ -0,0 +1,134 @@
+#include "loop_stats.hpp"
+#include <bit>
+#include <sstream>
+#include <cstdlib>
+
+namespace {
+/// @brief Single writer increment, cheaper than fetch_add
+void increment(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+}
+
+Histogram::Histogram():
+    total{0}, maxValue{0}
+{
+    for(auto& bucket: buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+int Histogram::bucketIndex(std::uint64_t value)
+{
+    // Values below 2*SUB_COUNT are exact, higher are split into SUB_COUNT buckets per power of two
+    if(value < 2*SUB_COUNT) return static_cast<int>(value);
+    const int shift = std::bit_width(value) - 1 - SUB_BITS;
+    return (shift + 1)*SUB_COUNT + static_cast<int>((value >> shift) - SUB_COUNT);
+}
+
+std::uint64_t Histogram::bucketValue(int index)
+{
+    if(index < 2*SUB_COUNT) return index;
+    const int shift = index/SUB_COUNT - 1;
+    return static_cast<std::uint64_t>(SUB_COUNT + index%SUB_COUNT) << shift;
+}
+
+void Histogram::record(std::uint64_t value)
+{
+    increment(buckets[bucketIndex(value)]);
+    increment(total);
+    if(value > maxValue.load(std::memory_order_relaxed)) maxValue.store(value, std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::percentile(double fraction) const
+{
+    const std::uint64_t samples = count();
+    if(samples == 0) return 0;
+    const std::uint64_t rank = static_cast<std::uint64_t>(fraction*(samples - 1)) + 1;
+    std::uint64_t seen = 0;
+    for(int i = 0; i < BUCKETS; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if(seen >= rank) return bucketValue(i);
+    }
+    return max();
+}
+
+std::uint64_t Histogram::max() const
+{
+    return maxValue.load(std::memory_order_relaxed);
+}
+
+LoopStats::LoopStats(std::string name, std::chrono::nanoseconds period):
+    name{name}, period{period.count()}, missed{0}
+{}
+
+void LoopStats::begin(Clock::time_point scheduled)
+{
+    start = Clock::now();
+    const std::int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(start - scheduled).count();
+    wakeLatency.record(latency > 0 ? latency : 0);
+    if(lastStart.time_since_epoch().count() != 0)
+    {
+        const std::int64_t measured = std::chrono::duration_cast<std::chrono::nanoseconds>(start - lastStart).count();
+        jitter.record(std::llabs(measured - period));
+    }
+    lastStart = start;
+}
+
+void LoopStats::begin()
+{
+    start = Clock::now();
+}
+
+void LoopStats::end()
+{
+    const std::int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    execution.record(elapsed);
+    // Loop without wall clock period (lockstep, fused navigation) has no deadline
+    if(period > 0 && elapsed > period) increment(missed);
+}
+
+std::uint64_t LoopStats::count() const
+{
+    return execution.count();
+}
+
+const Histogram& LoopStats::executionTime() const
+{
+    return execution;
+}
+
+const Histogram& LoopStats::periodJitter() const
+{
+    return jitter;
+}
+
+std::uint64_t LoopStats::missedDeadlines() const
+{
+    return missed.load(std::memory_order_relaxed);
+}
+
+std::string LoopStats::report() const
+{
+    auto line = [](std::stringstream& ss, const char* label, const Histogram& h)
+    {
+        ss << "  " << label << " [us]: p50 " << h.percentile(0.5)/1000.0
+            << ", p99 " << h.percentile(0.99)/1000.0
+            << ", p99.9 " << h.percentile(0.999)/1000.0
+            << ", max " << h.max()/1000.0 << "\n";
+    };
+    std::stringstream ss;
+    ss.precision(4);
+    ss << name << ": " << execution.count() << " iterations, " << missed.load(std::memory_order_relaxed)
+        << " missed deadlines\n";
+    line(ss, "execution", execution);
+    if(period == 0) return ss.str();
+    line(ss, "wake latency", wakeLatency);
+    line(ss, "jitter", jitter);
+    return ss.str();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// @brief Log-linear histogram of durations in ns, 16 linear sub-buckets per power of two (relative error below 6.25%).
+/// Single thread records, any thread may read. Recording is wait-free.
+class Histogram
+{
+public:
+    /// @brief Constructor
+    Histogram();
+
+    /// @brief Adds sample. Only one thread may call it.
+    /// @param value sample in ns
+    void record(std::uint64_t value);
+
+    /// @brief Returns number of samples
+    /// @return samples count
+    std::uint64_t count() const;
+
+    /// @brief Returns value below which given fraction of samples lies
+    /// @param fraction fraction of samples in range [0,1]
+    /// @return lower bound of bucket containing percentile in ns
+    std::uint64_t percentile(double fraction) const;
+
+    /// @brief Returns largest sample
+    /// @return maximal value in ns
+    std::uint64_t max() const;
+
+private:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BITS) * SUB_COUNT;
+
+    static int bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketValue(int index);
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> maxValue;
+};
+
+/// @brief Timing of periodic loop: wake-up latency, execution time, period jitter and missed deadlines
+class LoopStats
+{
+public:
+    /// @brief Constructor
+    /// @param name loop name used in report
+    /// @param period nominal loop period, zero if loop is not paced by wall clock (only execution time is recorded)
+    LoopStats(std::string name, std::chrono::nanoseconds period);
+
+    /// @brief Marks beginning of loop iteration paced by wall clock
+    /// @param scheduled time at which iteration was supposed to wake up
+    void begin(std::chrono::steady_clock::time_point scheduled);
+
+    /// @brief Marks beginning of loop iteration which is not paced by wall clock
+    void begin();
+
+    /// @brief Marks end of loop iteration
+    void end();
+
+    /// @brief Prepares human readable statistics. Safe to call from other thread.
+    /// @return statistics report
+    std::string report() const;
+
+    /// @brief Returns number of measured iterations
+    /// @return iterations count
+    std::uint64_t count() const;
+
+    /// @brief Returns histogram of execution times
+    /// @return execution time histogram
+    const Histogram& executionTime() const;
+
+    /// @brief Returns histogram of period jitter
+    /// @return jitter histogram
+    const Histogram& periodJitter() const;
+
+    /// @brief Returns number of iterations that ended after their deadline
+    /// @return missed deadlines count
+    std::uint64_t missedDeadlines() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string name;
+    const std::int64_t period;
+    Clock::time_point lastStart;
+    Clock::time_point start;
+
+    /// @brief delay of iteration start after its scheduled wake-up time
+    Histogram wakeLatency;
+    /// @brief time between begin and end
+    Histogram execution;
+    /// @brief absolute difference between measured and nominal period
+    Histogram jitter;
+    /// @brief iterations that ended after their deadline
+    std::atomic<std::uint64_t> missed;
+};
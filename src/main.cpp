@@ -10,6 +10,8 @@
 #include "controller/controller.hpp"
 #include "common.hpp"
 #include "params.hpp"
+#include "realtime.hpp"
+#include "async_log.hpp"
 
 std::string log_path = "logs/";
 
@@ -25,6 +27,20 @@ void parseArgs(int argc, char** argv, UAVparams* params, Params& p)
 		("c,config", "Path of config file", cxxopts::value<std::string>()->default_value("config.xml"))
         ("n,name", "Override name from config", cxxopts::value<std::string>()->default_value(""))
         ("dt", "Step time of simulation in ms. Default: 1 ms", cxxopts::value<int>())
+        ("binary-state", "Receive state as one binary frame per physics step")
+        ("shm", "Use shared memory rings for state and commands")
+        ("batch-commands", "Send all actuator commands of one step as single message")
+        ("fused", "Run navigation and control in one loop on single thread")
+        ("lockstep", "Run one control step per simulator step, as fast as simulator goes. Implies --fused, requires --binary-state or --shm")
+        ("rt-control", "SCHED_FIFO priority of control thread", cxxopts::value<int>())
+        ("rt-ns", "SCHED_FIFO priority of navigation thread", cxxopts::value<int>())
+        ("cpu-control", "CPUs of control thread, e.g. 2,3", cxxopts::value<std::vector<int>>())
+        ("cpu-ns", "CPUs of navigation thread", cxxopts::value<std::vector<int>>())
+        ("cpu-io", "CPUs of communication threads", cxxopts::value<std::vector<int>>())
+        ("mlock", "Lock memory and prefault stacks")
+        ("seed", "Seed of sensors noise, same seed and --lockstep reproduce run", cxxopts::value<std::uint64_t>())
+        ("binary-log", "Write logs to binary file, convert with log_to_csv")
+        ("metrics", "Publish controller metrics with given rate in Hz", cxxopts::value<double>())
         ("h,help", "Print usage");
     auto result = options.parse(argc, argv);
     if(result.count("help"))
@@ -37,12 +53,58 @@ void parseArgs(int argc, char** argv, UAVparams* params, Params& p)
         p.STEP_TIME = result["dt"].as<int>()/1000.0;
         std::cout << "Step time changed to " << p.STEP_TIME << "s" << std::endl;
     }
+    if(result.count("binary-state"))
+    {
+        p.BINARY_STATE = true;
+        std::cout << "Using binary state protocol" << std::endl;
+    }
+    if(result.count("shm"))
+    {
+        p.SHM_TRANSPORT = true;
+        std::cout << "Using shared memory transport" << std::endl;
+    }
+    if(result.count("batch-commands"))
+    {
+        p.BATCH_COMMANDS = true;
+        std::cout << "Batching actuator commands" << std::endl;
+    }
+    if(result.count("fused"))
+    {
+        p.FUSED_PIPELINE = true;
+        std::cout << "Using fused navigation and control pipeline" << std::endl;
+    }
+    if(result.count("lockstep"))
+    {
+        // Only binary frames carry step number which simulator expects in acknowledge
+        if(!p.BINARY_STATE && !p.SHM_TRANSPORT)
+        {
+            std::cerr << "--lockstep requires --binary-state or --shm" << std::endl;
+            exit(1);
+        }
+        p.LOCKSTEP = true;
+        p.FUSED_PIPELINE = true;
+        std::cout << "Using lockstep with simulator" << std::endl;
+    }
+    if(result.count("rt-control")) p.CONTROL_PRIORITY = result["rt-control"].as<int>();
+    if(result.count("rt-ns")) p.NS_PRIORITY = result["rt-ns"].as<int>();
+    if(result.count("cpu-control")) p.CONTROL_CPUS = result["cpu-control"].as<std::vector<int>>();
+    if(result.count("cpu-ns")) p.NS_CPUS = result["cpu-ns"].as<std::vector<int>>();
+    if(result.count("cpu-io")) p.IO_CPUS = result["cpu-io"].as<std::vector<int>>();
+    if(result.count("mlock")) p.LOCK_MEMORY = true;
+    if(result.count("binary-log")) p.BINARY_LOG = true;
+    if(result.count("seed")) p.NOISE_SEED = result["seed"].as<std::uint64_t>();
+    if(result.count("metrics"))
+    {
+        p.METRICS_RATE = result["metrics"].as<double>();
+        std::cout << "Publishing metrics at " << p.METRICS_RATE << " Hz" << std::endl;
+    }
     params->loadConfig(result["config"].as<std::string>().c_str());
     if(result.count("name"))
     {
         params->name = result["name"].as<std::string>();
     }
     std::cout << "Name: " << params->name <<std::endl;
+    std::cout << "Noise seed: " << p.NOISE_SEED << std::endl;
 }
 
 int main(int argc, char** argv)
@@ -51,12 +113,16 @@ int main(int argc, char** argv)
     UAVparams params;
     Params p{};
     parseArgs(argc,argv,&params, p);
+    if(p.LOCK_MEMORY) realtime::lockMemory();
     Logger::setLogDirectory(params.name);
 	std::string uav_address = "ipc:///tmp/" + std::string(params.name);
     std::string folder = "/tmp/" + std::string(params.name);
     std::cout << "Looking for folder: " << folder << std::endl;
     while(!std::filesystem::exists(folder)) std::this_thread::sleep_for(std::chrono::milliseconds(100));
     std::cout << "Comunication folder found!" << std::endl;
+    // Declared before controller, so writer outlives all loggers
+    std::unique_ptr<AsyncLogWriter> log_writer;
+    if(p.BINARY_LOG) log_writer = std::make_unique<AsyncLogWriter>(log_path + std::string(params.name) + "/log.bin");
 	ControlSystem controller(&ctx,uav_address);
 	controller.run();
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include <Eigen/Dense>
+#include <mutex>
 #include <random>
 #include <optional>
 #include "environment.hpp"
 #include "sensors.hpp"
+#include "../async_log.hpp"
 
 /// @brief Attitude and heading reference system
 class AHRS
@@ -36,5 +38,5 @@ protected:
     std::mutex mtxOri;
 
     Environment& env;
-    Logger logger;
+    LogChannel logger;
 };
\ No newline at end of file
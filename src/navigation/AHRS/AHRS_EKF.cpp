@@ -105,7 +105,7 @@ void AHRS_EKF::update(Eigen::Vector3d gyro, Eigen::Vector3d acc, Eigen::Vector3d
     mtxOri.lock();
     ori_est = ori;
     mtxOri.unlock();
-    logger.log(time,{ori,x});
+    logger.log(time, ori, x);
     last_update = time;
 }
 
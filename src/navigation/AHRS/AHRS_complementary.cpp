@@ -120,5 +120,5 @@ void AHRS_complementary::update(Eigen::Vector3d gyro, Eigen::Vector3d acc, Eigen
     mtxOri.lock();
     ori_est = new_ori;
     mtxOri.unlock();
-    logger.log(time,{new_ori, ori_gyro, ori_acc});
+    logger.log(time, new_ori, ori_gyro, ori_acc);
 }
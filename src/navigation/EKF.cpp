@@ -5,6 +5,9 @@
 
 EKF::EKF(EKFParams params):
     logger("EKF.csv", "Time,PosX,PosY,PosZ,VelX,VelY,VelZ"),
+    innovationBaro{0.0},
+    innovationGPS{0.0},
+    innovationGPSVel{0.0},
     params{params}
 {
     const UAVparams* uav_params = UAVparams::getSingleton();
@@ -56,12 +59,21 @@ void EKF::predict(double time, Eigen::Vector3d acc)
     last_update = time;
 }
 
+EKFInnovations EKF::getInnovations()
+{
+    return EKFInnovations{innovationBaro.load(std::memory_order_relaxed),
+        innovationGPS.load(std::memory_order_relaxed),
+        innovationGPSVel.load(std::memory_order_relaxed)};
+}
+
 void EKF::updateBaro(double time, double baro) 
 {
     if(time == 0.0) return;
     std::scoped_lock lck(mtx);
     auto K = P * CBaro.transpose() / (CBaro*P*CBaro.transpose() + params.RBaro);
-    x = x + K*(baro - CBaro*x);
+    const double innovation = baro - (CBaro*x)(0);
+    innovationBaro.store(std::abs(innovation), std::memory_order_relaxed);
+    x = x + K*innovation;
     P = (Eigen::Matrix<double,6,6>::Identity() - K*CBaro)*P;
 }
 
@@ -71,7 +83,9 @@ void EKF::updateGPS(double time, Eigen::Vector3d pos)
     std::scoped_lock lck(mtx);
     Eigen::Matrix3d inv_den = (CGPSPos*P*CGPSPos.transpose() + params.RGPSPos).inverse();
     auto K =  P * CGPSPos.transpose() * inv_den;
-    x = x + K*(pos - CGPSPos*x);
+    const Eigen::Vector3d innovation = pos - CGPSPos*x;
+    innovationGPS.store(innovation.norm(), std::memory_order_relaxed);
+    x = x + K*innovation;
     P = (Eigen::Matrix<double,6,6>::Identity() - K*CGPSPos)*P;
 }
 
@@ -81,12 +95,14 @@ void EKF::updateGPSVel(double time, Eigen::Vector3d vel)
     std::scoped_lock lck(mtx);
     Eigen::Matrix3d inv_den = (CGPSVel*P*CGPSVel.transpose() + params.RGPSVel).inverse();
     auto K =  P * CGPSVel.transpose() * inv_den;
-    x = x + K*(vel - CGPSVel*x);
+    const Eigen::Vector3d innovation = vel - CGPSVel*x;
+    innovationGPSVel.store(innovation.norm(), std::memory_order_relaxed);
+    x = x + K*innovation;
     P = (Eigen::Matrix<double,6,6>::Identity() - K*CGPSVel)*P;
 }
 
 void EKF::log(double time) 
 {
     std::scoped_lock lck(mtx);
-    logger.log(time,{x});
+    logger.log(time, x);
 }
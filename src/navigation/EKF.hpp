@@ -1,7 +1,10 @@
 #pragma once
 #include <Eigen/Dense>
+#include <mutex>
+#include <atomic>
 #include "environment.hpp"
 #include "sensors.hpp"
+#include "../async_log.hpp"
 
 
 /// @brief EK filer parameters
@@ -14,6 +17,14 @@ struct EKFParams
     Eigen::Matrix3d RGPSVel;
 };
 
+/// @brief Norms of last innovations of EKF updates
+struct EKFInnovations
+{
+    double baro;
+    double gps;
+    double gpsVel;
+};
+
 /// @brief Extended Kalman Filter
 class EKF
 {
@@ -32,6 +43,10 @@ public:
     /// @return velocity vector in world frame
     Eigen::Vector3d getVel();
 
+    /// @brief Returns norms of last innovations. Safe to call from other thread.
+    /// @return innovations norms
+    EKFInnovations getInnovations();
+
     /// @brief Predict phase. Integration of accelerometer measures.
     /// @param time simulation time
     /// @param acc accelerometer measure
@@ -58,8 +73,11 @@ public:
     void log(double time);
 
 private:
-    Logger logger;
+    LogChannel logger;
     std::mutex mtx;
+    std::atomic<double> innovationBaro;
+    std::atomic<double> innovationGPS;
+    std::atomic<double> innovationGPSVel;
     Eigen::Vector<double,6> x;
     Eigen::Matrix<double,6,6> P;
 
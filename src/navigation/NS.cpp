@@ -4,12 +4,24 @@
 #include "AHRS/AHRS_EKF.hpp"
 #include "AHRS/AHRS_complementary.hpp"
 #include "../defines.hpp"
+#include "../async_log.hpp"
 #include "../params.hpp"
+#include "../realtime.hpp"
 
 
 NS::NS(Environment &env):
     env{env},
-    loop(std::round(Params::getSingleton()->STEP_TIME*1000.0),[this](){job();},status)
+    accelerometer{env.sensors.require<Accelerometer>()},
+    gyroscope{env.sensors.require<Gyroscope>()},
+    magnetometer{env.sensors.require<Magnetometer>()},
+    barometer{env.sensors.require<Barometer>()},
+    gps{env.sensors.require<GPS>()},
+    gpsVel{env.sensors.require<GPSVel>()},
+    loop(std::round(Params::getSingleton()->STEP_TIME*1000.0),
+        [this](std::chrono::steady_clock::time_point scheduled){stats.begin(scheduled); step(); stats.end();},status),
+    // In fused pipeline step is paced by control loop, it has no own period
+    stats("NS loop", Params::getSingleton()->FUSED_PIPELINE ? std::chrono::milliseconds(0)
+        : std::chrono::milliseconds(std::lround(Params::getSingleton()->STEP_TIME*1000.0)))
 {
     std::cout << "NS initializing..." << std::endl;
     const UAVparams* params = UAVparams::getSingleton();
@@ -25,63 +37,129 @@ NS::NS(Environment &env):
     if(ahrs.get() != nullptr) std::cout << "AHRS OK" << std::endl;
     ekf = std::make_unique<EKF>(calcParams());
     std::cout << "Parameters calculated" << std::endl;
-    loop_thread = std::thread([this]() {loop.go();});
+    publishSolution(0.0);
+    // In fused pipeline control loop drives navigation
+    if(!Params::getSingleton()->FUSED_PIPELINE) loop_thread = std::thread([this]()
+    {
+        const Params* p = Params::getSingleton();
+        realtime::configureThread("ns", p->NS_PRIORITY, p->NS_CPUS);
+        AsyncLogWriter::registerThread();
+        if(p->LOCK_MEMORY) realtime::prefaultStack();
+        loop.go();
+    });
     std::cout << "NS initialized" << std::endl;
 }
 
 NS::~NS()
 {
     status = Status::exiting;
-    loop_thread.join();
+    if(loop_thread.joinable()) loop_thread.join();
+    if(stats.count() > 0) std::cout << stats.report();
+}
+
+NavigationSolution NS::getSolution() const
+{
+    return solution.load();
 }
 
 Eigen::Vector3d NS::getPosition()
 {
-    return ekf->getPos();
+    return solution.load().position;
 }
 
 Eigen::Vector3d NS::getLinearVelocity()
 {
-    return ekf->getVel();
+    return solution.load().linearVelocity;
 }
 
 Eigen::Vector3d NS::getOrientation()
 {
-    return ahrs->getOri();
+    return solution.load().orientation;
 }
 
 Eigen::Vector3d NS::getAngularVelocity()
 {
-    return env.sensorsVec3d.at("gyroscope")->getReading() - ahrs->getGyroBias();
+    return solution.load().angularVelocity;
 }
 
 Eigen::Matrix3d NS::getRotationMatrixBodyToWorld()
 {
-    return ahrs->rot_bw();
+    return solution.load().R_bw;
 }
 
-void NS::job() 
+void NS::fusedStep()
 {
-    env.updateSensors();
-    double time = env.getTime();
+    stats.begin();
+    step();
+    stats.end();
+}
 
-    if(env.sensorsVec3d.at("accelerometer")->isReady() && env.sensorsVec3d.at("magnetometer")->isReady() && env.sensorsVec3d.at("gyroscope")->isReady())
+std::string NS::timingReport() const
+{
+    if(stats.count() == 0) return "";
+    return stats.report();
+}
+
+const LoopStats& NS::loopStats() const
+{
+    return stats;
+}
+
+EKFInnovations NS::getInnovations()
+{
+    return ekf->getInnovations();
+}
+
+void NS::publishSolution(double time)
+{
+    NavigationSolution nav;
+    nav.time = time;
+    nav.position = ekf->getPos();
+    nav.linearVelocity = ekf->getVel();
+    nav.orientation = ahrs->getOri();
+    nav.gyroBias = ahrs->getGyroBias();
+    nav.angularVelocity = gyroscope.getReading() - nav.gyroBias;
+    nav.R_bw = ahrs->rot_bw();
+    solution.store(nav);
+}
+
+void NS::step() 
+{
+    EnvState state = env.getSnapshot();
+    pending |= env.updateSensors(state);
+    double time = state.time;
+
+    // AHRS needs all three inertial measures, they are collected until last one arrives
+    if(pending.has(SensorType::ACCELEROMETER) && pending.has(SensorType::MAGNETOMETER) && pending.has(SensorType::GYROSCOPE))
     {
-        auto acc = env.sensorsVec3d.at("accelerometer")->getReading();
-        ahrs->update(env.sensorsVec3d.at("gyroscope")->getReading(), acc.normalized(), env.sensorsVec3d.at("magnetometer")->getReading().normalized());
+        const Eigen::Vector3d& acc = accelerometer.getReading();
+        ahrs->update(gyroscope.getReading(), acc.normalized(), magnetometer.getReading().normalized());
         ekf->predict(time, ahrs->rot_bw()*acc - Accelerometer::g);
+        pending.remove(SensorType::ACCELEROMETER);
+        pending.remove(SensorType::MAGNETOMETER);
+        pending.remove(SensorType::GYROSCOPE);
     }
 
-    if(env.sensors.at("barometer")->isReady())
-        ekf->updateBaro(time, env.sensors.at("barometer")->getReading());
+    if(pending.has(SensorType::BAROMETER))
+    {
+        ekf->updateBaro(time, barometer.getReading());
+        pending.remove(SensorType::BAROMETER);
+    }
     
-    if(env.sensorsVec3d.at("GPS")->isReady())
-        ekf->updateGPS(time, env.sensorsVec3d.at("GPS")->getReading());
+    if(pending.has(SensorType::GPS_POSITION))
+    {
+        ekf->updateGPS(time, gps.getReading());
+        pending.remove(SensorType::GPS_POSITION);
+    }
 
-    if(env.sensorsVec3d.at("GPSVel")->isReady())
-        ekf->updateGPSVel(time, env.sensorsVec3d.at("GPSVel")->getReading());
+    if(pending.has(SensorType::GPS_VELOCITY))
+    {
+        ekf->updateGPSVel(time, gpsVel.getReading());
+        pending.remove(SensorType::GPS_VELOCITY);
+    }
 
     ekf->log(time);
+    publishSolution(time);
 }
 
 EKFParams NS::calcParams()
@@ -95,19 +173,19 @@ EKFParams NS::calcParams()
 
     EKFParams p;
     p.Q.setZero();
-    p.Q.block<3,3>(0,0) = ((std::pow(step_time,4)/4.0)* std::pow(env.sensorsVec3d.at("gyroscope")->getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
-    p.Q.block<3,3>(3,0) = ((std::pow(step_time,3)/2.0)* std::pow(env.sensorsVec3d.at("gyroscope")->getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
-    p.Q.block<3,3>(0,3) = ((std::pow(step_time,3)/2.0)* std::pow(env.sensorsVec3d.at("gyroscope")->getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
-    p.Q.block<3,3>(3,3) = ((std::pow(step_time,2)/1.0)* std::pow(env.sensorsVec3d.at("gyroscope")->getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
+    p.Q.block<3,3>(0,0) = ((std::pow(step_time,4)/4.0)* std::pow(gyroscope.getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
+    p.Q.block<3,3>(3,0) = ((std::pow(step_time,3)/2.0)* std::pow(gyroscope.getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
+    p.Q.block<3,3>(0,3) = ((std::pow(step_time,3)/2.0)* std::pow(gyroscope.getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
+    p.Q.block<3,3>(3,3) = ((std::pow(step_time,2)/1.0)* std::pow(gyroscope.getSd(),2)) * predict_scaler * Eigen::Matrix3d::Identity();
     p.Q(2,2) *= z_extra_scaler;
     p.Q(2,5) *= z_extra_scaler;
     p.Q(5,2) *= z_extra_scaler;
     p.Q(5,5) *= z_extra_scaler;
-    p.RBaro = std::pow(env.sensors.at("barometer")->getSd(),2) * update_scaler * baro_scaler;
+    p.RBaro = std::pow(barometer.getSd(),2) * update_scaler * baro_scaler;
     p.RGPSPos.setIdentity();
-    p.RGPSPos = Eigen::Matrix3d::Identity() * std::pow(env.sensorsVec3d.at("GPS")->getSd(),2) * update_scaler;
+    p.RGPSPos = Eigen::Matrix3d::Identity() * std::pow(gps.getSd(),2) * update_scaler;
     p.RGPSVel.setIdentity();
-    p.RGPSVel = Eigen::Matrix3d::Identity() *std::pow(env.sensorsVec3d.at("GPSVel")->getSd(),2) * update_scaler;
+    p.RGPSVel = Eigen::Matrix3d::Identity() *std::pow(gpsVel.getSd(),2) * update_scaler;
     p.P0.setZero();
     return p;
 }
@@ -4,6 +4,28 @@
 #include "sensors.hpp"
 #include "AHRS.hpp"
 #include "EKF.hpp"
+#include "../seqlock.hpp"
+#include "../loop_stats.hpp"
+#include "../controller/loop_clock.hpp"
+
+/// @brief Output of navigation system, published once per navigation step
+struct NavigationSolution
+{
+    /// @brief simulation time of estimation step
+    double time;
+    /// @brief position in world frame
+    Eigen::Vector3d position;
+    /// @brief linear velocity in world frame
+    Eigen::Vector3d linearVelocity;
+    /// @brief orientation (RPY) in world frame
+    Eigen::Vector3d orientation;
+    /// @brief rates in body frame, corrected by gyroscope bias
+    Eigen::Vector3d angularVelocity;
+    /// @brief estimated gyroscope bias
+    Eigen::Vector3d gyroBias;
+    /// @brief rotation matrix from body to world frame
+    Eigen::Matrix3d R_bw;
+};
 
 /// @brief Navigation system
 class NS
@@ -17,6 +39,10 @@ public:
     /// @brief Deconstructor
     ~NS();
     
+    /// @brief Returns last navigation solution. All fields come from the same estimation step.
+    /// @return navigation solution
+    NavigationSolution getSolution() const;
+
     /// @brief Returns position estimated by NS
     /// @return position vector in world frame
     Eigen::Vector3d getPosition();
@@ -37,15 +63,46 @@ public:
     /// @return rotation matrix
     Eigen::Matrix3d getRotationMatrixBodyToWorld();
 
+    /// @brief Runs one navigation step: sensors update and estimation.
+    /// In fused pipeline it is called by control loop, otherwise NS runs it in own loop.
+    void step();
+
+    /// @brief Runs navigation step from control loop in fused pipeline and records its execution time
+    void fusedStep();
+
+    /// @brief Returns timing statistics of NS loop
+    /// @return statistics report, empty if no step was run
+    std::string timingReport() const;
+
+    /// @brief Returns timing statistics of NS loop. Safe to call from other thread.
+    /// In fused pipeline only execution time of step is recorded.
+    /// @return loop statistics
+    const LoopStats& loopStats() const;
+
+    /// @brief Returns norms of last EKF innovations. Safe to call from other thread.
+    /// @return innovations norms
+    EKFInnovations getInnovations();
+
 private:
     Environment& env;
+    /// @brief sensors resolved once at construction
+    Accelerometer& accelerometer;
+    Gyroscope& gyroscope;
+    Magnetometer& magnetometer;
+    Barometer& barometer;
+    GPS& gps;
+    GPSVel& gpsVel;
+    /// @brief new measurements not consumed by estimation yet
+    SensorEvents pending;
     std::unique_ptr<AHRS> ahrs;
     std::unique_ptr<EKF> ekf;
+    SeqLock<NavigationSolution> solution;
 
     std::thread loop_thread;
-    TimedLoop loop;
+    WallClock loop;
+    LoopStats stats;
     Status status;
 
-    void job();
     EKFParams calcParams();
+    void publishSolution(double time);
 };
\ No newline at end of file
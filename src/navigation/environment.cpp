@@ -2,60 +2,93 @@
 #include <zmq.hpp>
 #include <thread>
 #include <Eigen/Dense>
-#include <mutex>
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <sstream>
+#include <cstring>
+#include <chrono>
 #include <initializer_list>
-#include "../utils.hpp"
 #include "common.hpp"
 #include "sensors.hpp"
+#include "noise.hpp"
 #include "../defines.hpp"
+#include "../params.hpp"
+#include "../communication/state_msg.hpp"
+#include "../communication/shm_ring.hpp"
+#include "../realtime.hpp"
 
-void connectConflateSocket(zmq::socket_t& sock, std::string address, std::string topic)
+/// @brief Address of inproc socket used to wake up listener
+/// @param env environment instance
+/// @return inproc address unique for environment
+std::string wakeAddress(const void* env)
 {
-    sock.set(zmq::sockopt::rcvtimeo,1);
+    std::stringstream ss;
+    ss << "inproc://env-wake-" << env;
+    return ss.str();
+}
+
+/// @brief Connects SUB socket that keeps only newest message of topic
+/// @param sock socket to connect
+/// @param address publisher address
+/// @param topic subscribed topic
+/// @param timeout receive timeout in ms, -1 if socket is only read after poll
+void connectConflateSocket(zmq::socket_t& sock, std::string address, std::string topic, int timeout = -1)
+{
+    sock.set(zmq::sockopt::rcvtimeo,timeout);
     sock.set(zmq::sockopt::conflate,1);
     sock.set(zmq::sockopt::subscribe, topic);
     sock.connect(address);
 }
 
 Environment::Environment(zmq::context_t *ctx, std::string uav_address):
+    sensors(*this, UAVparams::getSingleton()->sensors,
+        vehicleSeed(Params::getSingleton()->NOISE_SEED, std::string(UAVparams::getSingleton()->name))),
     time_sock(*ctx,zmq::socket_type::sub),
     pos_sock(*ctx,zmq::socket_type::sub),
     vel_sock(*ctx,zmq::socket_type::sub),
     vel_world_sock(*ctx,zmq::socket_type::sub),
     accel_sock(*ctx,zmq::socket_type::sub),
+    state_sock(*ctx,zmq::socket_type::sub),
+    wake_sock(*ctx,zmq::socket_type::pair),
+    wake_listener_sock(*ctx,zmq::socket_type::pair),
     logger("env.csv", 
     "time,PosX,PosY,PosZ,Roll,q0,qx,"
     "qy,qz,VelX,VelY,VelZ,OmX,OmY,OmZ,"
     "VelBX,VelBY,VelBZ,OmBX,OmBY,OmBZ,"
     "AccBX,AccBY,AccBZ,EpsBX,EpsBY,EpsBZ")
 {
-    for(auto& sensor: UAVparams::getSingleton()->sensors)
-    {   
-        if(sensor.name.compare("accelerometer") == 0)
-            sensorsVec3d.insert(std::make_pair(sensor.name,std::make_unique<Accelerometer>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-        if(sensor.name.compare("gyroscope") == 0)
-            sensorsVec3d.insert(std::make_pair(sensor.name,std::make_unique<Gyroscope>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-        if(sensor.name.compare("magnetometer") == 0)
-            sensorsVec3d.insert(std::make_pair(sensor.name,std::make_unique<Magnetometer>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-        if(sensor.name.compare("barometer") == 0)
-            sensors.insert(std::make_pair(sensor.name,std::make_unique<Barometer>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-        if(sensor.name.compare("GPS") == 0)
-            sensorsVec3d.insert(std::make_pair(sensor.name,std::make_unique<GPS>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-        if(sensor.name.compare("GPSVel") == 0)
-            sensorsVec3d.insert(std::make_pair(sensor.name,std::make_unique<GPSVel>(*this,sensor.sd,sensor.bias,sensor.refreshTime)));
-    }
-    
     uav_address += "/state";
-    connectConflateSocket(time_sock, uav_address, "t:");
-    connectConflateSocket(pos_sock, uav_address, "pos:");
-    connectConflateSocket(vel_sock, uav_address, "vb:");
-    connectConflateSocket(vel_world_sock, uav_address, "vn:");
-    connectConflateSocket(accel_sock, uav_address, "ab:");
+    if(Params::getSingleton()->SHM_TRANSPORT)
+    {
+        const std::string ring_name = ShmRing::channelName(UAVparams::getSingleton()->name, "state");
+        std::cout << "Looking for shared memory: " << ring_name << std::endl;
+        while(!(state_ring = ShmRing::open(ring_name))) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    else if(Params::getSingleton()->BINARY_STATE)
+    {
+        connectConflateSocket(state_sock, uav_address, state_msg::TOPIC);
+    }
+    else
+    {
+        // Remaining topics of step are published right after time
+        connectConflateSocket(time_sock, uav_address, "t:");
+        connectConflateSocket(pos_sock, uav_address, "pos:", 1);
+        connectConflateSocket(vel_sock, uav_address, "vb:", 1);
+        connectConflateSocket(vel_world_sock, uav_address, "vn:", 1);
+        connectConflateSocket(accel_sock, uav_address, "ab:", 1);
+    }
+    wake_listener_sock.bind(wakeAddress(this));
+    wake_sock.connect(wakeAddress(this));
+    time.store(0.0,std::memory_order_relaxed);
+    frameSeq = 0;
+    rejectedFrames.store(0,std::memory_order_relaxed);
+    notifyState = Params::getSingleton()->LOCKSTEP;
     run.store(true,std::memory_order_relaxed);
-    listener = std::thread(&Environment::listenerJob, this);
+    if(state_ring)
+        listener = std::thread(&Environment::shmListenerJob, this);
+    else
+        listener = std::thread(&Environment::listenerJob, this);
 
     std::cout << "Initializing environment done" << std::endl;
 }
@@ -63,6 +96,8 @@ Environment::Environment(zmq::context_t *ctx, std::string uav_address):
 Environment::~Environment()
 {
     run.store(false,std::memory_order_relaxed);
+    wake_sock.send(zmq::str_buffer("exit"),zmq::send_flags::dontwait);
+    if(state_ring) state_ring->interrupt();
     listener.join();
 
     time_sock.close();
@@ -70,6 +105,11 @@ Environment::~Environment()
     vel_sock.close();
     vel_world_sock.close();
     accel_sock.close();
+    state_sock.close();
+    wake_sock.close();
+    wake_listener_sock.close();
+    if(rejectedFrames.load() > 0)
+        std::cout << "Rejected state frames: " << rejectedFrames.load() << std::endl;
     std::cout << "Env exited." << std::endl;
 }
 
@@ -78,6 +118,21 @@ double Environment::getTime()
     return time.load();
 }
 
+std::uint64_t Environment::getRejectedFrames()
+{
+    return rejectedFrames.load();
+}
+
+std::uint64_t Environment::getStateFrames() const
+{
+    return state.version();
+}
+
+std::uint64_t Environment::getDroppedFrames() const
+{
+    return state_ring ? state_ring->dropped() : 0;
+}
+
 template <int Size1, int Size2>
 bool recvVectors(zmq::socket_t& sock, int skip, Eigen::Vector<double,Size1>& vec1, Eigen::Vector<double,Size2>& vec2)
 {
@@ -116,6 +171,31 @@ bool recvVectors(zmq::socket_t& sock, int skip, Eigen::Vector<double,Size1>& vec
     return false;
 }
 
+/// @brief Receives binary state frame. Frame is decoded directly from zmq buffer.
+/// @param sock conflate socket subscribed to binary state topic
+/// @param msg reusable zmq message
+/// @param state decoded state
+/// @param rejected counter of invalid frames
+/// @return true if receive failed or message is invalid
+bool recvStateMsg(zmq::socket_t& sock, zmq::message_t& msg, state_msg::StateMsg& state,
+    std::atomic<std::uint64_t>& rejected)
+{
+    if(!sock.recv(msg, zmq::recv_flags::none))
+    {
+        if(zmq_errno() != EAGAIN) std::cerr << " listener recv error" << std::endl;
+        return true;
+    }
+    if(msg.size() < state_msg::TOPIC_LEN
+        || !state_msg::decode(static_cast<const char*>(msg.data()) + state_msg::TOPIC_LEN,
+                              msg.size() - state_msg::TOPIC_LEN, state))
+    {
+        std::cerr << "Invalid or torn state frame" << std::endl;
+        rejected++;
+        return true;
+    }
+    return false;
+}
+
 Eigen::Matrix<double, 3, 3> r_nb(const Eigen::Vector3d&  RPY)
 {
     double fi = RPY(0);
@@ -140,58 +220,148 @@ Eigen::Matrix<double, 3, 3> r_nb(const Eigen::Vector4d&  e)
 
 void Environment::listenerJob() 
 {
-    double msg_time;
-    Eigen::Vector3d msg_position;
-#if USE_QUATERIONS
-    Eigen::Vector4d msg_orientation;
-#else
-    Eigen::Vector3d msg_orientation;
-#endif
-    Eigen::Vector3d msg_worldLinearVelocity;
-    Eigen::Vector3d msg_worldAngularVelocity;
-    Eigen::Vector3d msg_linearVelocity;
-    Eigen::Vector3d msg_angularVelocity;
-    Eigen::Vector3d msg_linearAcceleration;
-    Eigen::Vector3d msg_angularAcceleration;
-    Eigen::Matrix3d msg_r_nb;
+    realtime::configureThread("env", 0, Params::getSingleton()->IO_CPUS);
+    AsyncLogWriter::registerThread();
+    EnvState msg_state;
+
+    const bool binary = Params::getSingleton()->BINARY_STATE;
+    zmq::message_t frame_buf;
+    state_msg::StateMsg frame;
+
+    // Sleep until new step is published or destructor wakes listener up
+    zmq::pollitem_t items[] = {
+        {(binary ? state_sock : time_sock).handle(), 0, ZMQ_POLLIN, 0},
+        {wake_listener_sock.handle(), 0, ZMQ_POLLIN, 0}
+    };
 
     while(run.load())
     {
-        zmq::message_t msg;
-        if(!time_sock.recv(msg, zmq::recv_flags::none))
+        try
+        {
+            zmq::poll(items, 2, std::chrono::milliseconds(-1));
+        }
+        catch(const zmq::error_t& ze)
         {
-            if(zmq_errno() != EAGAIN) std::cerr << " listener recv error" << std::endl;
+            std::cerr << "Listener poll error: " << ze.num() << std::endl;
             continue;
         }
-        std::string msg_str =  std::string(static_cast<char*>(msg.data()), msg.size());
-        //std::cout << "[" << msg_str << "]" << std::endl;
-        msg_time = std::stod(msg_str.substr(2));
-        if(recvVectors(pos_sock,4,msg_position,msg_orientation)) continue;
-        if(recvVectors(vel_sock,3,msg_linearVelocity,msg_angularVelocity)) continue;
-        if(recvVectors(vel_world_sock,3,msg_worldLinearVelocity,msg_worldAngularVelocity)) continue;
-        if(recvVectors(accel_sock,3,msg_linearAcceleration,msg_angularAcceleration)) continue;
-        msg_r_nb = r_nb(msg_orientation);
-
-        time.store(msg_time,std::memory_order_consume);
-        safeSet(position,msg_position,mtxPos);
-        safeSet(orientation,msg_orientation,mtxOri);
-        safeSet(R_nb,msg_r_nb,mtxRnb);
-        safeSet(worldLinearVelocity,msg_worldLinearVelocity,mtxWorldLinVel);
-        safeSet(worldAngularVelocity,msg_worldAngularVelocity,mtxWorldAngVel);
-        safeSet(linearVelocity,msg_linearVelocity,mtxLinVel);
-        safeSet(angularVelocity,msg_angularVelocity,mtxAngVel);
-        safeSet(linearAcceleration,msg_linearAcceleration,mtxLinAcc);
-        safeSet(angularAcceleration,msg_angularAcceleration,mtxAngAcc);
-        logger.log(msg_time,{msg_position, msg_orientation,
-                   msg_worldLinearVelocity, msg_worldAngularVelocity,
-                   msg_linearVelocity, msg_angularVelocity,
-                   msg_linearAcceleration, msg_angularAcceleration});    
+        if(items[1].revents & ZMQ_POLLIN) break;
+        if(!(items[0].revents & ZMQ_POLLIN)) continue;
+
+        if(binary)
+        {
+            if(recvStateMsg(state_sock,frame_buf,frame,rejectedFrames)) continue;
+            if(!acceptFrame(frame,msg_state)) continue;
+        }
+        else
+        {
+            zmq::message_t msg;
+            if(!time_sock.recv(msg, zmq::recv_flags::none))
+            {
+                if(zmq_errno() != EAGAIN) std::cerr << " listener recv error" << std::endl;
+                continue;
+            }
+            std::string msg_str =  std::string(static_cast<char*>(msg.data()), msg.size());
+            //std::cout << "[" << msg_str << "]" << std::endl;
+            msg_state.time = std::stod(msg_str.substr(2));
+            if(recvVectors(pos_sock,4,msg_state.position,msg_state.orientation)) continue;
+            if(recvVectors(vel_sock,3,msg_state.linearVelocity,msg_state.angularVelocity)) continue;
+            if(recvVectors(vel_world_sock,3,msg_state.worldLinearVelocity,msg_state.worldAngularVelocity)) continue;
+            if(recvVectors(accel_sock,3,msg_state.linearAcceleration,msg_state.angularAcceleration)) continue;
+        }
+        publishState(msg_state);
+    }
+}
+
+void Environment::shmListenerJob()
+{
+    realtime::configureThread("env", 0, Params::getSingleton()->IO_CPUS);
+    AsyncLogWriter::registerThread();
+    EnvState msg_state;
+    state_msg::StateMsg frame;
+    char buf[state_msg::TOPIC_LEN + sizeof(state_msg::StateMsg)];
+
+    while(run.load())
+    {
+        if(!state_ring->wait(std::chrono::milliseconds(100))) continue;
+        // Keep only newest frame, like conflate socket
+        std::size_t size = 0;
+        bool received = false;
+        while(state_ring->pop(buf, sizeof(buf), size)) received = true;
+        if(!received) continue;
+        if(size != sizeof(buf)
+            || std::memcmp(buf, state_msg::TOPIC, state_msg::TOPIC_LEN) != 0
+            || !state_msg::decode(buf + state_msg::TOPIC_LEN, size - state_msg::TOPIC_LEN, frame))
+        {
+            std::cerr << "Invalid or torn state frame" << std::endl;
+            rejectedFrames++;
+            continue;
+        }
+        if(!acceptFrame(frame,msg_state)) continue;
+        publishState(msg_state);
+    }
+}
+
+bool Environment::acceptFrame(const state_msg::StateMsg& frame, EnvState& msg_state)
+{
+    // Stale frame from previous step, zero means restart of physics engine
+    if(frame.seq != 0 && frame.seq <= frameSeq)
+    {
+        rejectedFrames++;
+        return false;
+    }
+    frameSeq = frame.seq;
+    msg_state.seq = frame.seq;
+    msg_state.time = frame.time;
+    msg_state.position = Eigen::Map<const Eigen::Vector3d>(frame.position);
+    msg_state.orientation = Eigen::Map<const decltype(msg_state.orientation)>(frame.orientation);
+    msg_state.linearVelocity = Eigen::Map<const Eigen::Vector3d>(frame.linearVelocity);
+    msg_state.angularVelocity = Eigen::Map<const Eigen::Vector3d>(frame.angularVelocity);
+    msg_state.worldLinearVelocity = Eigen::Map<const Eigen::Vector3d>(frame.worldLinearVelocity);
+    msg_state.worldAngularVelocity = Eigen::Map<const Eigen::Vector3d>(frame.worldAngularVelocity);
+    msg_state.linearAcceleration = Eigen::Map<const Eigen::Vector3d>(frame.linearAcceleration);
+    msg_state.angularAcceleration = Eigen::Map<const Eigen::Vector3d>(frame.angularAcceleration);
+    return true;
+}
+
+void Environment::publishState(EnvState& msg_state)
+{
+    msg_state.R_nb = r_nb(msg_state.orientation);
+
+    state.store(msg_state);
+    time.store(msg_state.time,std::memory_order_release);
+    if(notifyState)
+    {
+        // Empty critical section orders publish with waiter's check
+        { std::lock_guard<std::mutex> lock(stateMtx); }
+        stateCv.notify_all();
     }
+    logger.log(msg_state.time, msg_state.position, msg_state.orientation,
+               msg_state.worldLinearVelocity, msg_state.worldAngularVelocity,
+               msg_state.linearVelocity, msg_state.angularVelocity,
+               msg_state.linearAcceleration, msg_state.angularAcceleration);    
+}
+
+std::uint64_t Environment::waitForState(std::uint64_t version, std::chrono::milliseconds timeout, std::uint64_t& seq)
+{
+    {
+        std::unique_lock<std::mutex> lock(stateMtx);
+        stateCv.wait_for(lock, timeout, [this, version]() { return state.version() != version; });
+    }
+    // Step number is published with state, so it always belongs to returned version
+    std::uint64_t current;
+    seq = state.load(current).seq;
+    return current;
+}
+
+EnvState Environment::getSnapshot()
+{
+    return state.load();
 }
 
 Eigen::Vector3d Environment::getPosition()
 {
-    return safeGet(position,mtxPos);
+    return state.load().position;
 }
 
 #if USE_QUATERIONS
@@ -200,52 +370,45 @@ Eigen::Vector4d Environment::getOrientation()
 Eigen::Vector3d Environment::getOrientation()
 #endif
 {
-    return safeGet(orientation,mtxOri);
+    return state.load().orientation;
 }
 
 Eigen::Vector3d Environment::getWorldLinearVelocity() 
 {
-  return safeGet(worldLinearVelocity,mtxWorldLinVel);
+  return state.load().worldLinearVelocity;
 }
 
 Eigen::Vector3d Environment::getWorldAngularVelocity()
 {
-  return safeGet(worldAngularVelocity,mtxWorldAngVel);
+  return state.load().worldAngularVelocity;
 }
 
 Eigen::Vector3d Environment::getLinearVelocity()
 {
-    return safeGet(linearVelocity,mtxLinVel);
+    return state.load().linearVelocity;
 }
 
 Eigen::Vector3d Environment::getAngularVelocity()
 {
-    return safeGet(angularVelocity,mtxAngVel);
+    return state.load().angularVelocity;
 }
 
 Eigen::Vector3d Environment::getLinearAcceleration()
 {
-    return safeGet(linearAcceleration,mtxLinAcc);
+    return state.load().linearAcceleration;
 }
 
 Eigen::Vector3d Environment::getAngularAcceleraton()
 {
-    return safeGet(angularAcceleration,mtxAngAcc);
+    return state.load().angularAcceleration;
 }
 
 Eigen::Matrix3d Environment::getRnb()
 {
-    return safeGet(R_nb, mtxRnb);
+    return state.load().R_nb;
 }
 
-void Environment::updateSensors() 
+SensorEvents Environment::updateSensors(const EnvState& snapshot) 
 {
-    for (auto& [_, value]: sensors)
-    {
-        value->update();
-    }
-    for (auto& [_, value]: sensorsVec3d)
-    {
-        value->update();
-    }
+    return sensors.update(snapshot);
 }
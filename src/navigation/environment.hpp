@@ -2,14 +2,42 @@
 #include <zmq.hpp>
 #include <thread>
 #include <Eigen/Dense>
-#include <mutex>
 #include <vector>
 #include <memory>
 #include <atomic>
-#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "sensors.hpp"
+#include "sensor_registry.hpp"
 #include "common.hpp"
 #include "../defines.hpp"
+#include "../seqlock.hpp"
+#include "../communication/state_msg.hpp"
+#include "../communication/shm_ring.hpp"
+#include "../async_log.hpp"
+
+/// @brief Exact state of UAV from one physics step
+struct EnvState
+{
+    /// @brief step number of simulator, 0 after physics restart or if text protocol is used
+    std::uint64_t seq = 0;
+    double time = 0.0;
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+#if USE_QUATERIONS
+    Eigen::Vector4d orientation = Eigen::Vector4d(1.0,0.0,0.0,0.0);
+#else
+    Eigen::Vector3d orientation = Eigen::Vector3d::Zero();
+#endif
+    Eigen::Vector3d worldLinearVelocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d worldAngularVelocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d linearVelocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d angularVelocity = Eigen::Vector3d::Zero();
+    Eigen::Vector3d linearAcceleration = Eigen::Vector3d::Zero();
+    Eigen::Vector3d angularAcceleration = Eigen::Vector3d::Zero();
+    /// @brief rotation matrix from world to body frame
+    Eigen::Matrix3d R_nb = Eigen::Matrix3d::Identity();
+};
 
 class Environment
 {
@@ -26,6 +54,10 @@ public:
     /// @return simulation time
     double getTime();
 
+    /// @brief Returns whole state from single physics step. Never blocks listener thread.
+    /// @return consistent state snapshot
+    EnvState getSnapshot();
+
 
     /// @brief Returns exact postion vector
     /// @return position vector in world frame
@@ -69,50 +101,59 @@ public:
     /// @return rotation matrix
     Eigen::Matrix3d getRnb();
 
-    /// @brief update all sensors
-    void updateSensors();
+    /// @brief Waits until state newer than given version is published. Used by lockstep mode only.
+    /// @param version version returned by previous call, 0 at start
+    /// @param timeout maximal wait time
+    /// @param seq step number of simulator carried by returned state
+    /// @return version of last published state, equal to given version on timeout
+    std::uint64_t waitForState(std::uint64_t version, std::chrono::milliseconds timeout, std::uint64_t& seq);
 
-    /// @brief map of sensors that measure values which is 3 element vector
-    std::map<std::string,std::unique_ptr<Sensor<Eigen::Vector3d>>> sensorsVec3d;
+    /// @brief Returns number of rejected (torn, invalid or stale) state frames
+    /// @return rejected frames count
+    std::uint64_t getRejectedFrames();
 
-    /// @brief map of sensors that measure single value
-    std::map<std::string,std::unique_ptr<Sensor<double>>> sensors;
+    /// @brief Returns number of state frames published to navigation
+    /// @return published states count
+    std::uint64_t getStateFrames() const;
+
+    /// @brief Returns number of state frames dropped by physics engine because shared memory ring was full
+    /// @return dropped frames count, 0 if zmq transport is used
+    std::uint64_t getDroppedFrames() const;
+
+    /// @brief Samples sensors which are due
+    /// @param snapshot state that sensors measure
+    /// @return sensors that measured new value
+    SensorEvents updateSensors(const EnvState& snapshot);
+
+    /// @brief sensors of UAV indexed by type
+    SensorRegistry sensors;
 
 private:
     std::atomic_bool run;
 
     std::atomic<double> time;
-    Eigen::Vector3d position;
-#if USE_QUATERIONS
-    Eigen::Vector4d orientation;
-#else
-    Eigen::Vector3d orientation;
-#endif
-    Eigen::Vector3d worldLinearVelocity;
-    Eigen::Vector3d worldAngularVelocity;
-    Eigen::Vector3d linearVelocity;
-    Eigen::Vector3d angularVelocity;
-    Eigen::Vector3d linearAcceleration;
-    Eigen::Vector3d angularAcceleration;
-    Eigen::Matrix3d R_nb;
-      
-    std::mutex mtxPos;
-    std::mutex mtxOri;
-    std::mutex mtxWorldLinVel;
-    std::mutex mtxWorldAngVel;
-    std::mutex mtxLinVel;
-    std::mutex mtxAngVel;
-    std::mutex mtxLinAcc;
-    std::mutex mtxAngAcc;
-    std::mutex mtxRnb;
+    std::uint64_t frameSeq;
+    std::atomic<std::uint64_t> rejectedFrames;
+    SeqLock<EnvState> state;
+
+    bool notifyState;
+    std::mutex stateMtx;
+    std::condition_variable stateCv;
 
     zmq::socket_t time_sock;
     zmq::socket_t pos_sock;
     zmq::socket_t vel_sock;
     zmq::socket_t vel_world_sock;
     zmq::socket_t accel_sock;
+    zmq::socket_t state_sock;
+    zmq::socket_t wake_sock;
+    zmq::socket_t wake_listener_sock;
+    std::unique_ptr<ShmRing> state_ring;
 
-    Logger logger;
+    LogChannel logger;
     std::thread listener;
     void listenerJob();
+    void shmListenerJob();
+    bool acceptFrame(const state_msg::StateMsg& frame, EnvState& msg_state);
+    void publishState(EnvState& msg_state);
 };
\ No newline at end of file
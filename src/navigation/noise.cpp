@@ -0,0 +1,72 @@
+#include "noise.hpp"
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+/// @brief SplitMix64 finalizer, spreads every input bit over whole output
+/// @param x input
+/// @return mixed value
+constexpr std::uint64_t mix64(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+}
+
+std::uint64_t vehicleSeed(std::uint64_t seed, std::string_view vehicle)
+{
+    // FNV-1a, std::hash is implementation defined
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for(const char c: vehicle)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return mix64(mix64(seed) ^ hash);
+}
+
+NoiseGenerator::NoiseGenerator(std::uint64_t seed, std::uint64_t stream):
+    key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+    stream{stream},
+    counter{0},
+    pos{BLOCK}
+{}
+
+void NoiseGenerator::refill()
+{
+    // Random bits for whole block first, counters are independent so loop has no carried dependency
+    std::array<std::uint32_t, BLOCK> bits;
+    for(int i = 0; i < BLOCK; i += 4)
+    {
+        std::array<std::uint32_t, 4> ctr = {
+            static_cast<std::uint32_t>(counter),
+            static_cast<std::uint32_t>(counter >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)
+        };
+        counter++;
+        philox(ctr, key);
+        bits[i] = ctr[0];
+        bits[i + 1] = ctr[1];
+        bits[i + 2] = ctr[2];
+        bits[i + 3] = ctr[3];
+    }
+    // Box-Muller on pairs of uniforms, u1 in (0,1] so logarithm is finite
+    constexpr double TO_UNIT = 1.0 / 4294967296.0;
+    for(int i = 0; i < BLOCK; i += 2)
+    {
+        const double u1 = (bits[i] + 1.0) * TO_UNIT;
+        const double u2 = bits[i + 1] * TO_UNIT;
+        const double r = std::sqrt(-2.0 * std::log(u1));
+        const double theta = 2.0 * std::numbers::pi * u2;
+        block[i] = r * std::cos(theta);
+        block[i + 1] = r * std::sin(theta);
+    }
+    pos = 0;
+}
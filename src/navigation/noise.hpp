@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/// @brief Philox4x32-10 bijection. In header so that known-answer check can test it directly.
+/// @param ctr counter, replaced by random bits
+/// @param key generator key
+inline void philox(std::array<std::uint32_t, 4>& ctr, std::array<std::uint32_t, 2> key)
+{
+    constexpr std::uint32_t M0 = 0xD2511F53;
+    constexpr std::uint32_t M1 = 0xCD9E8D57;
+    constexpr std::uint32_t W0 = 0x9E3779B9;
+    constexpr std::uint32_t W1 = 0xBB67AE85;
+    constexpr int ROUNDS = 10;
+    for(int round = 0; round < ROUNDS; round++)
+    {
+        const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * ctr[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * ctr[2];
+        ctr = {
+            static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+            static_cast<std::uint32_t>(p1),
+            static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+            static_cast<std::uint32_t>(p0)
+        };
+        key[0] += W0;
+        key[1] += W1;
+    }
+}
+
+/// @brief Gaussian noise source of single sensor.
+/// Uses counter-based Philox4x32-10 generator, so sequence depends only on seed, stream and sample index.
+/// Standard normal samples are produced in blocks, consumer only reads from buffer until it is empty.
+/// Not shared between threads, every sensor owns its generator.
+class NoiseGenerator
+{
+public:
+    /// @brief Number of samples generated at once
+    static constexpr int BLOCK = 64;
+
+    /// @brief Constructor
+    /// @param seed key of generator
+    /// @param stream index of independent sequence for given seed, e.g. sensor id
+    NoiseGenerator(std::uint64_t seed, std::uint64_t stream);
+
+    /// @brief Returns next standard normal sample
+    /// @return sample from N(0,1)
+    inline double next()
+    {
+        if(pos == BLOCK) refill();
+        return block[pos++];
+    }
+
+private:
+    /// @brief Generates next block of samples
+    void refill();
+
+    std::array<std::uint32_t, 2> key;
+    std::uint64_t stream;
+    /// @brief Philox counter of next block
+    std::uint64_t counter;
+    std::array<double, BLOCK> block;
+    int pos;
+};
+
+/// @brief Derives noise seed of vehicle, so vehicles sharing run seed get different noise.
+/// Uses stable hash of name, result is the same on every platform and build.
+/// @param seed seed of simulation run
+/// @param vehicle vehicle name
+/// @return seed of vehicle sensors
+std::uint64_t vehicleSeed(std::uint64_t seed, std::string_view vehicle);
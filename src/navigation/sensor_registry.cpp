@@ -0,0 +1,73 @@
+#include "sensor_registry.hpp"
+#include <algorithm>
+#include <functional>
+#include "environment.hpp"
+
+std::optional<SensorType> SensorTypeFromString(std::string_view name)
+{
+    if(name == "accelerometer") return SensorType::ACCELEROMETER;
+    if(name == "gyroscope") return SensorType::GYROSCOPE;
+    if(name == "magnetometer") return SensorType::MAGNETOMETER;
+    if(name == "barometer") return SensorType::BAROMETER;
+    if(name == "GPS") return SensorType::GPS_POSITION;
+    if(name == "GPSVel") return SensorType::GPS_VELOCITY;
+    return std::nullopt;
+}
+
+/// @brief Constructs sensor in place, sensors can not be moved
+/// @param slot storage of sensor
+/// @param type sensor type
+/// @param env environment sensor measures
+/// @param params sensor parameters
+/// @param seed seed of sensor noise
+void emplaceSensor(std::optional<Sensors>& slot, SensorType type, Environment& env, const SensorParams& params, std::uint64_t seed)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        ((I == static_cast<std::size_t>(type) ?
+            (slot.emplace(std::in_place_index<I>, env, params.sd, params.bias, params.refreshTime, seed), true) : false) || ...);
+    }(std::make_index_sequence<SENSOR_TYPE_COUNT>{});
+}
+
+SensorRegistry::SensorRegistry(Environment& env, const std::vector<SensorParams>& params, std::uint64_t seed)
+{
+    for(const auto& sensor: params)
+    {
+        const std::optional<SensorType> type = SensorTypeFromString(sensor.name);
+        if(!type.has_value())
+        {
+            std::cerr << "Unknown sensor: " << sensor.name << std::endl;
+            continue;
+        }
+        if(slots[*type].has_value())
+        {
+            std::cerr << "Duplicated sensor: " << sensor.name << std::endl;
+            continue;
+        }
+        emplaceSensor(slots[*type], *type, env, sensor, seed);
+        // First sample is taken once refresh time passes since simulation start
+        schedule[scheduled++] = Deadline{sensor.refreshTime, *type};
+    }
+    std::make_heap(schedule.begin(), schedule.begin() + scheduled, std::greater<Deadline>());
+}
+
+SensorEvents SensorRegistry::update(const EnvState& state)
+{
+    SensorEvents events;
+    const auto end = schedule.begin() + scheduled;
+    while(scheduled > 0 && state.time > schedule.front().time)
+    {
+        std::pop_heap(schedule.begin(), end, std::greater<Deadline>());
+        Deadline& due = *(end - 1);
+        const double refreshTime = std::visit([&state](auto& sensor)
+        {
+            sensor.update(state);
+            return sensor.getRefreshTime();
+        }, *slots[due.type]);
+        events.add(due.type);
+        // Next sample is relative to actual sample time, sensors do not catch up missed samples
+        due.time = state.time + refreshTime;
+        std::push_heap(schedule.begin(), end, std::greater<Deadline>());
+    }
+    return events;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <variant>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <string_view>
+#include <iostream>
+#include "sensors.hpp"
+#include "common.hpp"
+
+/// @brief All sensors. Alternative index is equal to SensorType enum value,
+/// adding sensor requires only enum value and entry here.
+using Sensors = std::variant<
+    Accelerometer,
+    Gyroscope,
+    Magnetometer,
+    Barometer,
+    GPS,
+    GPSVel
+>;
+
+static_assert(std::variant_size_v<Sensors> == SENSOR_TYPE_COUNT, "Every sensor type must be registered");
+static_assert([]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return ((std::variant_alternative_t<I, Sensors>::TYPE == static_cast<SensorType>(I)) && ...);
+    }(std::make_index_sequence<SENSOR_TYPE_COUNT>{}), "Sensor alternative index must match its TYPE");
+
+/// @brief Parses sensor name used in config
+/// @param name sensor name
+/// @return sensor type, empty if name is unknown
+std::optional<SensorType> SensorTypeFromString(std::string_view name);
+
+/// @brief Set of sensor types, e.g. sensors that measured new value
+class SensorEvents
+{
+public:
+    /// @brief Adds sensor type to set
+    /// @param type sensor type
+    void add(SensorType type) { mask |= bit(type); }
+
+    /// @brief Removes sensor type from set
+    /// @param type sensor type
+    void remove(SensorType type) { mask &= ~bit(type); }
+
+    /// @brief Checks if set contains sensor type
+    /// @param type sensor type
+    /// @return true if type is in set
+    bool has(SensorType type) const { return (mask & bit(type)) != 0; }
+
+    /// @brief Checks if set is empty
+    /// @return true if set has no types
+    bool empty() const { return mask == 0; }
+
+    /// @brief Adds all types of other set
+    /// @param other other set
+    /// @return reference to this set
+    SensorEvents& operator|=(const SensorEvents& other) { mask |= other.mask; return *this; }
+
+private:
+    static constexpr std::uint32_t bit(SensorType type) { return std::uint32_t{1} << type; }
+
+    std::uint32_t mask = 0;
+};
+
+/// @brief Sensors of UAV stored in one contiguous array indexed by type.
+/// Names are resolved once at construction, sensors are reached by type afterwards.
+class SensorRegistry
+{
+public:
+    /// @brief Constructor. Creates sensors listed in config.
+    /// @param env reference to environment sensors measure
+    /// @param params sensors parameters from config
+    /// @param seed seed of sensors noise, every sensor draws from own stream
+    SensorRegistry(Environment& env, const std::vector<SensorParams>& params, std::uint64_t seed);
+
+    SensorRegistry(const SensorRegistry&) = delete; // no copies
+    SensorRegistry& operator=(const SensorRegistry&) = delete; // no self-assignments
+
+    /// @brief Returns sensor of given type
+    /// @tparam S sensor class
+    /// @return pointer to sensor, nullptr if sensor is not configured
+    template <class S>
+    S* find()
+    {
+        std::optional<Sensors>& slot = slots[S::TYPE];
+        return slot.has_value() ? &std::get<S>(*slot) : nullptr;
+    }
+
+    /// @brief Returns sensor of given type. Exits if sensor is not configured.
+    /// @tparam S sensor class
+    /// @return reference to sensor
+    template <class S>
+    S& require()
+    {
+        S* sensor = find<S>();
+        if(sensor == nullptr)
+        {
+            std::cerr << "Missing sensor of type " << S::TYPE << " in config" << std::endl;
+            exit(1);
+        }
+        return *sensor;
+    }
+
+    /// @brief Samples sensors which are due. Sensors that are not due are not touched.
+    /// @param state exact state of UAV from single physics step
+    /// @return sensors that measured new value
+    SensorEvents update(const EnvState& state);
+
+private:
+    /// @brief Next sample of sensor
+    struct Deadline
+    {
+        double time;
+        SensorType type;
+        /// @brief Orders heap so earliest deadline is on top
+        bool operator>(const Deadline& other) const { return time > other.time; }
+    };
+
+    std::array<std::optional<Sensors>, SENSOR_TYPE_COUNT> slots;
+    /// @brief Min-heap of deadlines of configured sensors
+    std::array<Deadline, SENSOR_TYPE_COUNT> schedule;
+    int scheduled = 0;
+};
@@ -1,10 +1,26 @@
 #pragma once
 #include <Eigen/Dense>
-#include <random>
-#include <atomic>
+#include <cstdint>
+#include "noise.hpp"
 #include "common.hpp"
+#include "../async_log.hpp"
 
 class Environment;
+struct EnvState;
+
+/// @brief Sensor types. Each type has one slot in sensor registry.
+enum SensorType
+{
+    ACCELEROMETER = 0,
+    GYROSCOPE = 1,
+    MAGNETOMETER = 2,
+    BAROMETER = 3,
+    GPS_POSITION = 4,
+    GPS_VELOCITY = 5
+};
+
+/// @brief Number of sensor types
+constexpr int SENSOR_TYPE_COUNT = SensorType::GPS_VELOCITY + 1;
 
 /// @brief Sensors base class
 /// @tparam T type of data read by sensor
@@ -19,94 +35,107 @@ public:
     /// @param path path where sensor logs are saved
     /// @param fmt header of log file
     /// @param refreshTime sample period
+    /// @param seed seed of noise generator
+    /// @param stream noise sequence of sensor, different sensors must use different streams
     Sensor(Environment& env, double sd, T bias,
-        std::string path, std::string fmt, double refreshTime);
+        std::string path, std::string fmt, double refreshTime,
+        std::uint64_t seed, std::uint64_t stream);
 
-    /// @brief Update sensor state. Measured value is updated if sensor is ready for next read.
-    virtual void update() = 0;
+    /// @brief Measures next value. Called by sensor scheduler when sample is due.
+    /// @param state exact state of UAV from single physics step
+    virtual void update(const EnvState& state) = 0;
 
     /// @brief Returns recent measure
     /// @return sensor measure
-    inline T getReading() {
-        ready = false;
-        return value;
-        };
+    inline const T& getReading() const {return value;}
 
     /// @brief Returns standard deviation
     /// @return standard deviation
-    inline double getSd() {return dist.stddev();}
+    inline double getSd() {return sd;}
 
-    
-    /// @brief Checks if sensor is ready
-    /// @return true if sensor is ready
-    inline bool isReady() {return ready.load();}
+    /// @brief Returns sample period
+    /// @return sample period
+    inline double getRefreshTime() const {return refreshTime;}
 
 protected:
-    /// @brief Checks if sensor should measure next value
-    /// @return true if sensor is ready for next measure
-    bool shouldUpdate();
-
     Environment& env;
     T value;
     double refreshTime;
-    double lastUpdate;
-    std::atomic_bool ready;
 
-    static std::mt19937 gen;
-    std::normal_distribution<double> dist;
+    double sd;
+    NoiseGenerator noise;
     T bias;
     
-    double error();
-
-    Logger logger;
+    /// @brief Draws measurement error
+    /// @return sample from N(0,sd^2)
+    inline double error() {return sd*noise.next();}
+
+    /// @brief Draws independent errors of three axes
+    /// @return vector of samples from N(0,sd^2)
+    inline Eigen::Vector3d errorVector()
+    {
+        // Drawn one by one, order of constructor arguments evaluation is unspecified
+        const double x = noise.next();
+        const double y = noise.next();
+        const double z = noise.next();
+        return sd*Eigen::Vector3d(x,y,z);
+    }
+
+    LogChannel logger;
 };
 
 /// @brief Representation of accelerometer
-class Accelerometer : public Sensor<Eigen::Vector3d>
+class Accelerometer final : public Sensor<Eigen::Vector3d>
 {
 public:
-    Accelerometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::ACCELEROMETER;
+    Accelerometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
     static const Eigen::Vector3d g;
 };
 
 /// @brief Representation of gyroscope
-class Gyroscope : public Sensor<Eigen::Vector3d>
+class Gyroscope final : public Sensor<Eigen::Vector3d>
 {
 public:
-    Gyroscope(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::GYROSCOPE;
+    Gyroscope(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
 };
 
 /// @brief Representation of magnetometer
-class Magnetometer : public Sensor<Eigen::Vector3d>
+class Magnetometer final : public Sensor<Eigen::Vector3d>
 {
 public:
-    Magnetometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::MAGNETOMETER;
+    Magnetometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
     static const Eigen::Vector3d mag;
 };
 
 /// @brief Representation of barometer
-class Barometer : public Sensor<double>
+class Barometer final : public Sensor<double>
 {
 public:
-    Barometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::BAROMETER;
+    Barometer(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
 };
 
 /// @brief Representation of GPS position measure
-class GPS : public Sensor<Eigen::Vector3d>
+class GPS final : public Sensor<Eigen::Vector3d>
 {
 public:
-    GPS(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::GPS_POSITION;
+    GPS(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
 };
 
 /// @brief Representation of GPS velocity measure
-class GPSVel : public Sensor<Eigen::Vector3d>
+class GPSVel final : public Sensor<Eigen::Vector3d>
 {
 public:
-    GPSVel(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime);
-    void update() override;
+    static constexpr SensorType TYPE = SensorType::GPS_VELOCITY;
+    GPSVel(Environment& env, double sd, Eigen::Vector3d bias, double refreshTime, std::uint64_t seed);
+    void update(const EnvState& state) override;
 };
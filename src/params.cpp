@@ -1,5 +1,6 @@
 #include "params.hpp"
 #include <iostream>
+#include <random>
 
 Params* Params::_singleton = nullptr;
 
@@ -13,6 +14,18 @@ Params::Params()
     _singleton = this;
 
     STEP_TIME = 0.001;
+    BINARY_STATE = false;
+    SHM_TRANSPORT = false;
+    BATCH_COMMANDS = false;
+    FUSED_PIPELINE = false;
+    LOCKSTEP = false;
+    CONTROL_PRIORITY = 0;
+    NS_PRIORITY = 0;
+    LOCK_MEMORY = false;
+    METRICS_RATE = 0.0;
+    BINARY_LOG = false;
+    std::random_device rd;
+    NOISE_SEED = (static_cast<std::uint64_t>(rd()) << 32) | rd();
 }
 
 Params::~Params() 
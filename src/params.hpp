@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstdint>
 
 /// @brief Simulation parameters
 class Params
@@ -18,6 +20,48 @@ public:
     /// @brief Step time of simulation. Step of ODE solving methods
     double STEP_TIME;
 
+    /// @brief Use binary state protocol instead of text topics
+    bool BINARY_STATE;
+
+    /// @brief Exchange state and commands through shared memory rings instead of zmq
+    bool SHM_TRANSPORT;
+
+    /// @brief Send all actuator commands of one step as single message
+    bool BATCH_COMMANDS;
+
+    /// @brief Run sensors update, estimation and control job one after another in control loop instead of separate NS loop
+    bool FUSED_PIPELINE;
+
+    /// @brief Advance controller only when simulator publishes new step and acknowledge every step
+    bool LOCKSTEP;
+
+    /// @brief SCHED_FIFO priority of control loop thread, 0 for default policy
+    int CONTROL_PRIORITY;
+
+    /// @brief SCHED_FIFO priority of navigation loop thread, 0 for default policy
+    int NS_PRIORITY;
+
+    /// @brief CPUs of control loop thread, empty for no pinning
+    std::vector<int> CONTROL_CPUS;
+
+    /// @brief CPUs of navigation loop thread, empty for no pinning
+    std::vector<int> NS_CPUS;
+
+    /// @brief CPUs of communication threads (state listener, order server), empty for no pinning
+    std::vector<int> IO_CPUS;
+
+    /// @brief Lock process memory and prefault stacks of loop threads
+    bool LOCK_MEMORY;
+
+    /// @brief Seed of sensors noise. Random unless given, always printed so run can be repeated.
+    std::uint64_t NOISE_SEED;
+
+    /// @brief Write logs to binary file from background thread instead of CSV files
+    bool BINARY_LOG;
+
+    /// @brief Rate of metrics publishing in Hz, 0 disables metrics socket
+    double METRICS_RATE;
+
     /// @brief Get singleton of Params.
     /// @return const pointer to Params instance. Return nullptr if not initialized
     static const Params* getSingleton();
@@ -0,0 +1,57 @@
+#include "realtime.hpp"
+#include <iostream>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace realtime {
+
+namespace {
+/// @brief Size of stack touched by prefaultStack
+constexpr std::size_t STACK_PREFAULT = 256*1024;
+}
+
+bool lockMemory()
+{
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        std::cerr << "Unable to lock memory: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    prefaultStack();
+    std::cout << "Memory locked" << std::endl;
+    return true;
+}
+
+void prefaultStack()
+{
+    [[maybe_unused]] volatile unsigned char stack[STACK_PREFAULT];
+    for(std::size_t i = 0; i < STACK_PREFAULT; i += 4096) stack[i] = 0;
+}
+
+void configureThread(const std::string& name, int priority, const std::vector<int>& cpus)
+{
+    // Linux limits thread name to 15 characters
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    if(!cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(int cpu: cpus) CPU_SET(cpu, &set);
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if(err != 0) std::cerr << "Unable to pin " << name << " thread: " << std::strerror(err) << std::endl;
+    }
+    if(priority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = priority;
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if(err != 0)
+            std::cerr << "Unable to set SCHED_FIFO for " << name << " thread: " << std::strerror(err)
+                << ", running with default policy" << std::endl;
+        else
+            std::cout << name << " thread running with SCHED_FIFO priority " << priority << std::endl;
+    }
+}
+}
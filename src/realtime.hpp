@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/// @brief Real-time setup of process and threads. Every function only warns if it lacks privileges.
+namespace realtime {
+
+/// @brief Locks current and future memory pages (mlockall) and prefaults stack of calling thread
+/// @return true if memory was locked
+bool lockMemory();
+
+/// @brief Touches stack pages of calling thread, so they do not page fault in control loop
+void prefaultStack();
+
+/// @brief Applies scheduling policy and CPU affinity to calling thread
+/// @param name thread name, used in messages and visible in top/ps
+/// @param priority SCHED_FIFO priority (1-99), 0 keeps default policy
+/// @param cpus CPUs thread may run on, empty keeps default affinity
+void configureThread(const std::string& name, int priority, const std::vector<int>& cpus);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/// @brief Sequence lock for single writer and many readers.
+/// Writer never waits, readers do not take any lock and retry only if they overlapped with write.
+/// @tparam T type of protected value, should be cheap to copy
+template <typename T>
+class SeqLock
+{
+public:
+    /// @brief Constructor
+    SeqLock(): seq{0}, value{} {}
+
+    /// @brief Constructor
+    /// @param init initial value
+    explicit SeqLock(const T& init): seq{0}, value{init} {}
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// @brief Publish new value. Only one thread may call it.
+    /// @param new_val new value
+    void store(const T& new_val)
+    {
+        const std::uint64_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = new_val;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    /// @brief Read consistent copy of value
+    /// @return last published value
+    T load() const
+    {
+        T copy;
+        std::uint64_t before, after;
+        do
+        {
+            before = seq.load(std::memory_order_acquire);
+            copy = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+        } while((before & 1) || before != after);
+        return copy;
+    }
+
+    /// @brief Read consistent copy of value together with its version
+    /// @param version number of published values when copy was made
+    /// @return last published value
+    T load(std::uint64_t& version) const
+    {
+        T copy;
+        std::uint64_t before, after;
+        do
+        {
+            before = seq.load(std::memory_order_acquire);
+            copy = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+        } while((before & 1) || before != after);
+        version = before / 2;
+        return copy;
+    }
+
+    /// @brief Returns number of published values
+    /// @return publish counter
+    std::uint64_t version() const
+    {
+        return seq.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> seq;
+    T value;
+};
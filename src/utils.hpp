@@ -1,30 +1,5 @@
 #pragma once
 #include <Eigen/Dense>
-#include <mutex>
-
-/// @brief Safe setter for T type value protected by mutex
-/// @tparam T Type of variable
-/// @param vec value to be set
-/// @param new_val new value
-/// @param mtx mutex
-template <typename T>
-inline void safeSet(T& vec, T& new_val, std::mutex& mtx)
-{
-    std::lock_guard<std::mutex> guard(mtx);
-    vec = new_val;
-}
-
-/// @brief Safe getter for T type value protected by mutex
-/// @tparam T Type of variable
-/// @param vec value to be get
-/// @param mtx mutex
-/// @return value of vec
-template <typename T>
-inline T safeGet(T& vec, std::mutex& mtx)
-{
-    std::lock_guard<std::mutex> guard(mtx);
-    return vec;
-}
 
 /// @brief Calculates error between demanded and actual angle. Finds shorter path.
 /// For example if actual value is -0.9pi and demanded is 0.9pi error is equal -0.2pi
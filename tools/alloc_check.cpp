@@ -0,0 +1,91 @@
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <zmq.hpp>
+#include <cxxopts.hpp>
+#include <Eigen/Dense>
+#include "common.hpp"
+#include "../src/params.hpp"
+#include "../src/controller/mixers.hpp"
+#include "../src/communication/control.hpp"
+
+/// Checks that mixing and serialization of actuator commands does not allocate.
+/// Counts global operator new calls and forbids Eigen heap allocations (built with EIGEN_RUNTIME_NO_MALLOC).
+
+std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+    constexpr int ITERATIONS = 1000;
+
+    cxxopts::Options options("alloc_check", "Checks that mix and send path of control loop does not allocate");
+    options.add_options()
+        ("c,config", "Path of airframe config file", cxxopts::value<std::string>()->default_value("config.xml"))
+        ("h,help", "Print usage");
+    auto result = options.parse(argc, argv);
+    if(result.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    UAVparams params;
+    params.loadConfig(result["config"].as<std::string>().c_str());
+    Params p{};
+    // Batched commands are only serialized into frame, nothing is sent until commit
+    p.BATCH_COMMANDS = true;
+    initMixers();
+    zmq::context_t ctx;
+    Control control(&ctx, "inproc://alloc_check", nullptr);
+
+    std::size_t counted = 0;
+    for(int i = 0; i < ITERATIONS; i++)
+    {
+        const double rate = 0.001*i;
+        control.beginFrame();
+        const std::size_t before = allocations.load();
+        Eigen::internal::set_is_malloc_allowed(false);
+        control.sendSpeed(applyMixerRotors(1.0, rate, -rate, 0.5*rate));
+        control.sendSpeed(applyMixerRotorsHover(0.0, rate, -rate, 0.5*rate));
+        control.sendSurface(applyMixerSurfaces(0.5, rate, -rate, 0.5*rate));
+        control.sendHinge('r', 0, 1, 0.25);
+        Eigen::internal::set_is_malloc_allowed(true);
+        counted += allocations.load() - before;
+    }
+
+    std::cout << "Allocations in " << ITERATIONS << " ticks: " << counted << std::endl;
+    return counted == 0 ? 0 : 1;
+}
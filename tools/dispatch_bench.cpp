@@ -0,0 +1,143 @@
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+#include <optional>
+
+/// Micro benchmark of per-tick dispatch in control loop.
+/// Stand-in PID replaces UAV_common controller, only cost of reaching it differs between variants.
+/// Bound pointers are clearly faster than name lookup. std::visit and virtual call measure the same,
+/// variant of modes is kept for allocation-free mode switch, not for faster call.
+
+/// @brief Minimal PID with virtual calc, like controllers from config
+class Pid
+{
+public:
+    virtual ~Pid() = default;
+    virtual double calc(double demanded, double actual)
+    {
+        const double error = demanded - actual;
+        integral += error*0.001;
+        const double out = 0.5*error + 0.1*integral + 0.01*(error - last)/0.001;
+        last = error;
+        return out;
+    }
+
+private:
+    double integral = 0.0;
+    double last = 0.0;
+};
+
+/// @brief Measures average time of one call
+/// @param name printed name
+/// @param iterations number of calls
+/// @param f measured function
+template <class F>
+void measure(const char* name, int iterations, F f)
+{
+    double sink = 0.0;
+    // Warm up caches and branch predictors
+    for(int i = 0; i < iterations/10; i++) sink += f(i);
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++) sink += f(i);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+        << elapsed/iterations << " ns/tick  (" << sink << ")" << std::endl;
+}
+
+/// @brief Controller lookup: string keyed map every tick vs pointers bound once (QPOS uses 12 controllers)
+void benchLookup(int iterations)
+{
+    static const std::array<std::string, 12> names = {"Roll", "Pitch", "Yaw", "W", "Z", "Fi",
+        "Theta", "Psi", "X", "Y", "V", "U"};
+    std::map<std::string, std::unique_ptr<Pid>> controllers;
+    for(const auto& name: names) controllers.emplace(name, std::make_unique<Pid>());
+    std::array<Pid*, 12> bound;
+    for(std::size_t i = 0; i < names.size(); i++) bound[i] = controllers.at(names[i]).get();
+
+    measure("controllers.at(name) per call", iterations, [&](int i)
+    {
+        double out = 0.0;
+        for(const char* name: {"Roll", "Pitch", "Yaw", "W", "Z", "Fi", "Theta", "Psi", "X", "Y", "V", "U"})
+            out += controllers.at(name)->calc(i*1e-3, out);
+        return out;
+    });
+    measure("bound controller pointers", iterations, [&](int i)
+    {
+        double out = 0.0;
+        for(Pid* pid: bound) out += pid->calc(i*1e-3, out);
+        return out;
+    });
+}
+
+/// @brief Stand-in mode hierarchy, virtual job like former ControllerLoop
+class ModeBase
+{
+public:
+    virtual ~ModeBase() = default;
+    virtual double job(double input) = 0;
+};
+
+/// @brief Stand-in mode with non-virtual job, like modes dispatched through std::variant
+/// @tparam K distinguishes modes
+template <int K>
+class Mode
+{
+public:
+    double job(double input)
+    {
+        state = state*0.5 + input*K;
+        return state;
+    }
+
+private:
+    double state = 0.0;
+};
+
+/// @brief Same mode in virtual hierarchy
+/// @tparam K distinguishes modes
+template <int K>
+class VirtualMode : public ModeBase
+{
+public:
+    double job(double input) override { return mode.job(input); }
+
+private:
+    Mode<K> mode;
+};
+
+using Modes = std::variant<Mode<1>, Mode<2>, Mode<3>, Mode<4>, Mode<5>, Mode<6>, Mode<7>, Mode<8>, Mode<9>, Mode<10>, Mode<11>>;
+
+/// @brief Mode dispatch: virtual call through base pointer vs std::visit over preallocated variants
+void benchModeDispatch(int iterations)
+{
+    std::array<std::unique_ptr<ModeBase>, 3> heapModes = {std::make_unique<VirtualMode<1>>(), std::make_unique<VirtualMode<7>>(), std::make_unique<VirtualMode<11>>()};
+    std::array<std::optional<Modes>, 3> variantModes;
+    variantModes[0].emplace(std::in_place_index<0>);
+    variantModes[1].emplace(std::in_place_index<6>);
+    variantModes[2].emplace(std::in_place_index<10>);
+    // Active mode changes rarely, like in real run
+    ModeBase* volatile activeHeap = heapModes[1].get();
+    Modes* volatile activeVariant = &*variantModes[1];
+
+    measure("virtual job through base pointer", iterations, [&](int i)
+    {
+        return activeHeap->job(i*1e-3);
+    });
+    measure("std::visit over variant", iterations, [&](int i)
+    {
+        return std::visit([i](auto& mode) { return mode.job(i*1e-3); }, *activeVariant);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    std::cout << "Iterations: " << iterations << std::endl;
+    benchLookup(iterations);
+    benchModeDispatch(iterations);
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cxxopts.hpp>
+#include "../src/log_format.hpp"
+
+/// Converts binary log written by controller with --binary-log to CSV files.
+
+/// @brief Channel read from log
+struct Channel
+{
+    std::string name;
+    std::string fmt;
+    std::unique_ptr<std::ofstream> out;
+};
+
+/// @brief Reads whole log file
+/// @param path path of log file
+/// @param data file content without signature
+/// @return true if file is binary log
+bool readLog(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if(!in) return false;
+    char magic[sizeof(log_format::MAGIC)];
+    if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, log_format::MAGIC, sizeof(magic)) != 0) return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    cxxopts::Options options("log_to_csv", "Converts binary controller log to CSV files");
+    options.add_options()
+        ("i,input", "Binary log file", cxxopts::value<std::string>()->default_value("log.bin"))
+        ("o,output", "Directory of CSV files", cxxopts::value<std::string>()->default_value("."))
+        ("h,help", "Print usage");
+    auto result = options.parse(argc, argv);
+    if(result.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+    const std::string input = result["input"].as<std::string>();
+    const std::filesystem::path output = result["output"].as<std::string>();
+
+    std::vector<char> data;
+    if(!readLog(input, data))
+    {
+        std::cerr << "Not a binary log: " << input << std::endl;
+        return 1;
+    }
+    std::filesystem::create_directories(output);
+
+    // Channel header may be changed after first rows, last definition is used for whole file
+    std::map<std::uint16_t, Channel> channels;
+    for(int pass = 0; pass < 2; pass++)
+    {
+        std::size_t pos = 0;
+        std::size_t rows = 0;
+        std::size_t skipped = 0;
+        while(pos < data.size())
+        {
+            const std::uint8_t type = static_cast<std::uint8_t>(data[pos]);
+            if(type == log_format::CHANNEL && pos + sizeof(log_format::ChannelHeader) <= data.size())
+            {
+                log_format::ChannelHeader header;
+                std::memcpy(&header, data.data() + pos, sizeof(header));
+                pos += sizeof(header);
+                if(pos + header.nameLen + header.fmtLen > data.size()) break;
+                if(pass == 0)
+                {
+                    Channel& channel = channels[header.channel];
+                    channel.name.assign(data.data() + pos, header.nameLen);
+                    channel.fmt.assign(data.data() + pos + header.nameLen, header.fmtLen);
+                }
+                pos += header.nameLen + header.fmtLen;
+            }
+            else if(type == log_format::DATA && pos + sizeof(log_format::DataHeader) <= data.size())
+            {
+                log_format::DataHeader header;
+                std::memcpy(&header, data.data() + pos, sizeof(header));
+                pos += sizeof(header);
+                if(pos + header.count*sizeof(double) > data.size()) break;
+                // Channel header may be missing in truncated or partially flushed log, record is skipped
+                const auto channel = channels.find(header.channel);
+                if(pass == 1 && channel == channels.end())
+                {
+                    skipped++;
+                }
+                else if(pass == 1)
+                {
+                    std::ofstream& out = *channel->second.out;
+                    out << header.time;
+                    for(std::uint8_t i = 0; i < header.count; i++)
+                    {
+                        double value;
+                        std::memcpy(&value, data.data() + pos + i*sizeof(double), sizeof(double));
+                        out << ',' << value;
+                    }
+                    out << '\n';
+                    rows++;
+                }
+                pos += header.count*sizeof(double);
+            }
+            else
+            {
+                std::cerr << "Corrupted record at byte " << pos + sizeof(log_format::MAGIC) << ", rest of log skipped" << std::endl;
+                break;
+            }
+        }
+        if(pass == 0)
+        {
+            for(auto& [id, channel]: channels)
+            {
+                channel.out = std::make_unique<std::ofstream>(output / channel.name);
+                if(!channel.fmt.empty()) *channel.out << channel.fmt << '\n';
+            }
+        }
+        else
+        {
+            std::cout << "Converted " << rows << " rows of " << channels.size() << " files" << std::endl;
+            if(skipped > 0) std::cerr << "Skipped " << skipped << " records of channels without header" << std::endl;
+        }
+    }
+}
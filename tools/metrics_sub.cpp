@@ -0,0 +1,85 @@
+#include <iostream>
+#include <iomanip>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zmq.hpp>
+#include <cxxopts.hpp>
+#include "../src/communication/metrics_msg.hpp"
+
+/// Subscribes to metrics sockets of controllers and prints one line per received message.
+
+volatile std::sig_atomic_t stop = 0;
+
+void handleSignal(int)
+{
+    stop = 1;
+}
+
+/// @brief Prints loop metrics in compact form
+/// @param label loop label
+/// @param loop loop metrics
+void printLoop(const char* label, const metrics_msg::LoopMetrics& loop)
+{
+    std::cout << " " << label << "[n=" << loop.iterations << " miss=" << loop.missed
+        << " p50=" << loop.executionP50 << " p99=" << loop.executionP99
+        << " max=" << loop.executionMax << " jit99=" << loop.jitterP99 << "us]";
+}
+
+int main(int argc, char** argv)
+{
+    cxxopts::Options options("metrics_sub", "Prints metrics published by controllers");
+    options.add_options()
+        ("n,name", "Names of UAVs, e.g. UAV1,UAV2", cxxopts::value<std::vector<std::string>>()->default_value("UAV"))
+        ("h,help", "Print usage");
+    auto result = options.parse(argc, argv);
+    if(result.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    zmq::context_t ctx;
+    zmq::socket_t sock(ctx, zmq::socket_type::sub);
+    sock.set(zmq::sockopt::subscribe, metrics_msg::TOPIC);
+    sock.set(zmq::sockopt::rcvtimeo, 200);
+    for(const auto& name : result["name"].as<std::vector<std::string>>())
+    {
+        const std::string address = "ipc:///tmp/" + name + "/metrics";
+        std::cout << "Subscribing: " << address << std::endl;
+        sock.connect(address);
+    }
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::cout << std::fixed << std::setprecision(1);
+
+    while(!stop)
+    {
+        zmq::message_t msg;
+        if(!sock.recv(msg, zmq::recv_flags::none)) continue;
+        if(msg.size() < metrics_msg::TOPIC_LEN + sizeof(metrics_msg::MetricsMsg))
+        {
+            std::cerr << "Metrics message too short: " << msg.size() << std::endl;
+            continue;
+        }
+        metrics_msg::MetricsMsg m;
+        std::memcpy(&m, static_cast<const char*>(msg.data()) + metrics_msg::TOPIC_LEN, sizeof(m));
+        if(m.magic != metrics_msg::MAGIC || m.version != metrics_msg::VERSION || m.size != sizeof(m))
+        {
+            std::cerr << "Unsupported metrics message" << std::endl;
+            continue;
+        }
+        m.name[metrics_msg::NAME_LEN - 1] = '\0';
+        std::cout << m.name << " t=" << m.time << " mode=" << m.mode;
+        printLoop("ctl", m.control);
+        printLoop("ns", m.navigation);
+        std::cout << " state=" << m.stateFrames << "/" << m.rejectedFrames << "/" << m.droppedFrames
+            << " cmd=" << m.commandsSent << "/" << m.commandsDropped << "/" << m.commandErrors
+            << " inflight=" << m.commandsInFlight << " orders=" << m.orders
+            << std::setprecision(3)
+            << " innov=" << m.innovationBaro << "," << m.innovationGPS << "," << m.innovationGPSVel
+            << std::setprecision(1) << std::endl;
+    }
+    sock.close();
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include "../src/navigation/noise.hpp"
+
+/// Checks sensor noise generator. Reproducible Monte-Carlo runs depend on it, so any change of
+/// Philox rounds or of block Box-Muller must be detected here.
+
+/// @brief Known-answer vector of Philox4x32-10 from Random123 distribution
+struct PhiloxVector
+{
+    std::array<std::uint32_t, 4> ctr;
+    std::array<std::uint32_t, 2> key;
+    std::array<std::uint32_t, 4> expected;
+};
+
+constexpr std::array<PhiloxVector, 3> KAT = {{
+    {{0x00000000, 0x00000000, 0x00000000, 0x00000000}, {0x00000000, 0x00000000},
+     {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff},
+     {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0},
+     {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}
+}};
+
+/// @brief Compares Philox output with known answers
+/// @return true if all vectors match
+bool checkPhilox()
+{
+    bool ok = true;
+    for(const PhiloxVector& v: KAT)
+    {
+        std::array<std::uint32_t, 4> ctr = v.ctr;
+        philox(ctr, v.key);
+        if(ctr == v.expected) continue;
+        ok = false;
+        std::cerr << "Philox mismatch:" << std::hex;
+        for(const std::uint32_t word: ctr) std::cerr << " " << std::setw(8) << std::setfill('0') << word;
+        std::cerr << std::dec << std::endl;
+    }
+    return ok;
+}
+
+/// @brief Checks that first block of generator with zero seed and stream is Box-Muller of first known answer
+/// @return true if samples match
+bool checkFirstSamples()
+{
+    constexpr double TO_UNIT = 1.0 / 4294967296.0;
+    const std::array<std::uint32_t, 4>& bits = KAT[0].expected;
+    std::array<double, 4> expected;
+    for(int i = 0; i < 4; i += 2)
+    {
+        const double r = std::sqrt(-2.0 * std::log((bits[i] + 1.0) * TO_UNIT));
+        const double theta = 2.0 * std::numbers::pi * bits[i + 1] * TO_UNIT;
+        expected[i] = r * std::cos(theta);
+        expected[i + 1] = r * std::sin(theta);
+    }
+    NoiseGenerator gen(0, 0);
+    bool ok = true;
+    for(const double e: expected)
+    {
+        const double sample = gen.next();
+        if(std::abs(sample - e) > 1e-12)
+        {
+            std::cerr << "Sample mismatch: " << sample << ", expected " << e << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/// @brief Checks mean and variance of samples
+/// @param seed generator seed
+/// @param stream generator stream
+/// @return true if moments match N(0,1)
+bool checkMoments(std::uint64_t seed, std::uint64_t stream)
+{
+    constexpr int SAMPLES = 1 << 20;
+    NoiseGenerator gen(seed, stream);
+    double sum = 0.0;
+    double sumSq = 0.0;
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        const double x = gen.next();
+        sum += x;
+        sumSq += x*x;
+    }
+    const double mean = sum / SAMPLES;
+    const double variance = sumSq / SAMPLES - mean*mean;
+    // About 6 standard errors of estimate, false alarm is practically impossible
+    const bool ok = std::abs(mean) < 6.0/std::sqrt(SAMPLES) && std::abs(variance - 1.0) < 6.0*std::sqrt(2.0/SAMPLES);
+    std::cout << "seed " << seed << ", stream " << stream << ": mean " << mean << ", variance " << variance
+        << (ok ? "" : " FAILED") << std::endl;
+    return ok;
+}
+
+int main()
+{
+    bool ok = checkPhilox();
+    std::cout << "Philox known answers: " << (ok ? "ok" : "FAILED") << std::endl;
+    const bool samples = checkFirstSamples();
+    std::cout << "First samples: " << (samples ? "ok" : "FAILED") << std::endl;
+    ok = samples && ok;
+    ok = checkMoments(0, 0) && ok;
+    ok = checkMoments(vehicleSeed(42, "UAV"), 3) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <cxxopts.hpp>
+#include "../src/communication/shm_ring.hpp"
+#include "../src/communication/state_msg.hpp"
+
+/// Stand-in of physics engine for shared memory transport.
+/// Publishes state frames of UAV resting at origin and prints commands received from controller.
+
+volatile std::sig_atomic_t stop = 0;
+
+void handleSignal(int)
+{
+    stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+    cxxopts::Options options("shm_publisher", "Stand-in physics engine publishing state through shared memory");
+    options.add_options()
+        ("n,name", "Name of UAV", cxxopts::value<std::string>()->default_value("UAV"))
+        ("dt", "Step time of simulation in ms. Default: 1 ms", cxxopts::value<int>()->default_value("1"))
+        ("v,verbose", "Print every received command")
+        ("lockstep", "Publish next step only after controller acknowledges previous one")
+        ("h,help", "Print usage");
+    auto result = options.parse(argc, argv);
+    if(result.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+    const std::string name = result["name"].as<std::string>();
+    const int dt = result["dt"].as<int>();
+    const bool verbose = result.count("verbose") > 0;
+    const bool lockstep = result.count("lockstep") > 0;
+
+    // Controller binds order server in the same folder as with real simulator
+    std::filesystem::create_directories("/tmp/" + name);
+    auto state_ring = ShmRing::create(ShmRing::channelName(name, "state"), 64, 512);
+    auto cmd_ring = ShmRing::create(ShmRing::channelName(name, "control"), 256, 1024);
+    if(!state_ring || !cmd_ring) return 1;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::cout << "Publishing state of " << name << " every " << dt << " ms" << std::endl;
+
+    state_msg::StateMsg msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.magic = state_msg::MAGIC;
+    msg.version = state_msg::VERSION;
+    msg.size = sizeof(msg);
+    msg.orientation[0] = 1.0;
+
+    char frame[state_msg::TOPIC_LEN + sizeof(msg)];
+    char cmd[1024];
+    std::memcpy(frame, state_msg::TOPIC, state_msg::TOPIC_LEN);
+
+    bool running = false;
+    std::uint64_t seq = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t commands = 0;
+    auto next = std::chrono::steady_clock::now();
+    auto report = next + std::chrono::seconds(1);
+    while(!stop)
+    {
+        // Time flows only after controller sends start command
+        seq++;
+        if(running) msg.time += dt/1000.0;
+        msg.seq = seq;
+        msg.seqEnd = seq;
+        std::memcpy(frame + state_msg::TOPIC_LEN, &msg, sizeof(msg));
+        if(state_ring->push(frame, sizeof(frame))) frames++;
+        else state_ring->drop();
+
+        // In lockstep controller acknowledges step with "k:<seq>" once it is running
+        bool acked = !lockstep || !running;
+        do
+        {
+            std::size_t size;
+            while(cmd_ring->pop(cmd, sizeof(cmd), size))
+            {
+                std::string_view command(cmd, std::min(size, sizeof(cmd)));
+                commands++;
+                if(verbose) std::cout << "[" << command << "]" << std::endl;
+                if(command == "c:start") running = true;
+                if(command == "c:stop") stop = 1;
+                if(command == "k:" + std::to_string(seq)) acked = true;
+            }
+            if(!acked) std::this_thread::yield();
+        } while(!acked && !stop);
+
+        if(lockstep && running)
+        {
+            // Run as fast as controller goes, report once per simulated second
+            if(msg.time - std::floor(msg.time) < dt/1000.0)
+            {
+                std::cout << "t=" << msg.time << "s frames=" << frames << " commands=" << commands << std::endl;
+                frames = 0;
+                commands = 0;
+            }
+            continue;
+        }
+        next += std::chrono::milliseconds(dt);
+        if(next >= report)
+        {
+            std::cout << "t=" << msg.time << "s frames/s=" << frames << " commands/s=" << commands
+                << " dropped=" << state_ring->dropped() << std::endl;
+            frames = 0;
+            commands = 0;
+            report += std::chrono::seconds(1);
+        }
+        std::this_thread::sleep_until(next);
+    }
+    std::cout << "Exiting publisher" << std::endl;
+    return 0;
+}